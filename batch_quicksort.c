@@ -0,0 +1,137 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "parallel_sort.h"
+#include "parallel_stats.h"
+#include "parallel_tune.h"
+
+// Ordena varios archivos (o el mismo varias veces) en una sola sesión MPI, reutilizando
+// el contexto de parallel_sort: MPI_Init, el lanzamiento de procesos y los sub-comunicadores
+// se pagan una sola vez en lugar de una vez por archivo.
+// compilar ' mpicc batch_quicksort.c parallel_sort.c parallel_stats.c parallel_tune.c local_sort.c primes.c text_reader.c -o batch_quicksort -O3 -lm '
+// ejecutar ' mpirun -np 8 ./batch_quicksort -r 5 numeros4096.txt numeros32768.txt '
+
+// --- Prototipos de Funciones ---
+static bool is_sorted(const int *array, int n);
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int world_rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    // Argumentos: [-r repeticiones] archivo1 [archivo2 ...] [clave=valor ...]
+    int repetitions = 1;
+    int first_file = 1;
+    if (argc > 2 && argv[1][0] == '-' && argv[1][1] == 'r') {
+        repetitions = atoi(argv[2]);
+        first_file = 3;
+    }
+    int file_count = 0;
+    for (int f = first_file; f < argc; f++) { if (!psort_tuning_is_assignment(argv[f])) file_count++; }
+    if (file_count == 0 || repetitions < 1) {
+        if (world_rank == 0) {
+            fprintf(stderr, "Uso: %s [-r repeticiones] <archivo1> [archivo2 ...] [clave=valor ...]\n", argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Parámetros de PSORT_TUNING_FILE (si existe) con los "clave=valor" de la línea de comandos encima
+    PSortTuning tuning;
+    if (psort_tuning_setup(MPI_COMM_WORLD, PSORT_TUNING_FILE, argc, argv, &tuning) != PSORT_OK) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    double setup_start = MPI_Wtime();
+    PSortContext *ctx = psort_create_tuned(MPI_COMM_WORLD, &tuning);
+    if (!ctx) {
+        if (world_rank == 0) fprintf(stderr, "No se pudo crear el contexto: el número de procesos (%d) debe ser potencia de 2.\n", world_size);
+        MPI_Finalize();
+        return 1;
+    }
+    double setup_time = MPI_Wtime() - setup_start;
+    double batch_start = MPI_Wtime();
+
+    if (world_rank == 0) {
+        printf("Lote de %d archivo(s), %d repetición(es) cada uno, %d procesos.\n", file_count, repetitions, world_size);
+        printf("Preparación del contexto: %f segundos\n", setup_time);
+        psort_tuning_log(&tuning, stdout);
+    }
+
+    for (int f = first_file; f < argc; f++) {
+        if (psort_tuning_is_assignment(argv[f])) continue;
+        int N = 0;
+        int *global_array = NULL;
+        int status = PSORT_OK;
+
+        // El raíz lee el archivo una sola vez; un archivo inválido se salta sin abortar el lote
+        if (world_rank == 0) status = psort_read_file(argv[f], &global_array, &N);
+        MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (status != PSORT_OK) {
+            if (world_rank == 0) printf("\nADVERTENCIA: no se pudo leer '%s'. Saltando.\n", argv[f]);
+            continue;
+        }
+
+        int *sorted_array = (world_rank == 0) ? (int *)malloc(N * sizeof(int)) : NULL;
+
+        for (int r = 0; r < repetitions; r++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            double start_time = MPI_Wtime();
+
+            int local_n = 0;
+            int *local_array = NULL;
+            status = psort_scatter(ctx, global_array, &N, &local_array, &local_n);
+            if (status != PSORT_OK) {
+                if (world_rank == 0) {
+                    printf("\nADVERTENCIA: N (%d) de '%s' no es divisible por el número de procesos (%d). Saltando.\n", N, argv[f], world_size);
+                }
+                break;
+            }
+
+            PSortPlan plan;
+            plan.sorted_slices = 0; // psort_scatter reparte los datos tal como están en el archivo
+            psort_sort_auto(ctx, &local_array, &local_n, &plan);
+
+            // Todas las estadísticas en una pasada y un MPI_Reduce
+            PSortStats stats;
+            psort_stats(ctx, local_array, local_n, PSORT_STATS_ALL, plan.min_value, plan.max_value, &stats);
+
+            psort_gather(ctx, local_array, local_n, sorted_array);
+            free(local_array);
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            double end_time = MPI_Wtime();
+
+            if (world_rank == 0) {
+                printf("\n--- Resultados (%s, N=%d, repetición %d) ---\n", argv[f], N, r + 1);
+                psort_plan_log(&plan, stdout);
+                printf("%s\n", is_sorted(sorted_array, N) ? "Arreglo ordenado correctamente." : "ERROR: el arreglo no quedó ordenado.");
+                psort_stats_log(&stats, stdout);
+                printf("Tiempo de ejecución total: %f segundos\n", end_time - start_time);
+            }
+        }
+
+        free(sorted_array);
+        free(global_array);
+    }
+
+    double batch_time = MPI_Wtime() - batch_start;
+    if (world_rank == 0) {
+        printf("\nTiempo total del lote: %f segundos\n", batch_time);
+    }
+
+    psort_destroy(ctx);
+    MPI_Finalize();
+    return 0;
+}
+
+// --- Funciones Auxiliares ---
+
+static bool is_sorted(const int *array, int n) {
+    for (int i = 1; i < n; i++) { if (array[i - 1] > array[i]) return false; }
+    return true;
+}
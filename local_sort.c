@@ -0,0 +1,259 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "local_sort.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#define OMP(directive) _Pragma(#directive)
+#else
+#define OMP(directive) // Sin -fopenmp las directivas desaparecen y todo corre en un hilo
+#endif
+
+// Ordenamiento en memoria de un solo nodo: introsort + versión multihilo con tareas de OpenMP.
+
+#define INSERTION_SORT_THRESHOLD 24      // Tramos más cortos se ordenan por inserción
+#define NINTHER_THRESHOLD        128     // Desde este tamaño el pivote es la mediana de 9 (de Tukey)
+#define TASK_CUTOFF              16384   // Tramos más cortos no generan tareas: local_sort directo
+#define PARALLEL_PARTITION_MIN   262144  // Desde este tamaño la partición también se reparte entre hilos
+#define MAX_PARTITION_BLOCKS     64      // Bloques como máximo en una partición paralela
+
+// --- Prototipos de Funciones Internas ---
+static void introsort(int *array, int n, int depth_limit);
+static void insertion_sort(int *array, int n);
+static void heap_sort(int *array, int n);
+static void choose_pivot(int *array, int n);
+static int partition_hoare(int *array, int n);
+static int partition_le(int *array, int n, int pivot);
+static int partition_parallel(int *array, int *buffer, int n, int pivot, int blocks);
+static void sort_tasks(int *array, int *buffer, int n, int threads, int depth_limit);
+static int floor_log2(int n);
+
+static inline void swap_ints(int *a, int *b) { int t = *a; *a = *b; *b = t; }
+
+// ================== INTROSORT ==================
+
+void local_sort(int *array, int n) {
+    if (n < 2) return;
+    introsort(array, n, 2 * floor_log2(n));
+}
+
+static void introsort(int *array, int n, int depth_limit) {
+    while (n > INSERTION_SORT_THRESHOLD) {
+        // Demasiadas particiones malas: heapsort garantiza O(n log n)
+        if (depth_limit == 0) { heap_sort(array, n); return; }
+        depth_limit--;
+
+        choose_pivot(array, n);
+        int p = partition_hoare(array, n);
+
+        // Recursión en el lado menor y bucle en el mayor: la pila queda en O(log n)
+        if (p < n - p - 1) {
+            introsort(array, p, depth_limit);
+            array += p + 1;
+            n -= p + 1;
+        } else {
+            introsort(array + p + 1, n - p - 1, depth_limit);
+            n = p;
+        }
+    }
+    insertion_sort(array, n);
+}
+
+static void insertion_sort(int *array, int n) {
+    for (int i = 1; i < n; i++) {
+        int x = array[i];
+        int j = i;
+        while (j > 0 && array[j - 1] > x) { array[j] = array[j - 1]; j--; }
+        array[j] = x;
+    }
+}
+
+static void sift_down(int *array, int root, int n) {
+    int x = array[root];
+    for (;;) {
+        int child = 2 * root + 1;
+        if (child >= n) break;
+        if (child + 1 < n && array[child + 1] > array[child]) child++;
+        if (array[child] <= x) break;
+        array[root] = array[child];
+        root = child;
+    }
+    array[root] = x;
+}
+
+static void heap_sort(int *array, int n) {
+    for (int i = n / 2 - 1; i >= 0; i--) sift_down(array, i, n);
+    for (int i = n - 1; i > 0; i--) {
+        swap_ints(&array[0], &array[i]);
+        sift_down(array, 0, i);
+    }
+}
+
+// Ordena array[i], array[j], array[k] entre sí
+static inline void sort3(int *array, int i, int j, int k) {
+    if (array[j] < array[i]) swap_ints(&array[i], &array[j]);
+    if (array[k] < array[j]) {
+        swap_ints(&array[j], &array[k]);
+        if (array[j] < array[i]) swap_ints(&array[i], &array[j]);
+    }
+}
+
+// Deja en array[0] la mediana de 3 (o la mediana de medianas de 9 en tramos grandes)
+static void choose_pivot(int *array, int n) {
+    int mid = n / 2;
+    if (n >= NINTHER_THRESHOLD) {
+        int s = n / 8;
+        sort3(array, 0, s, 2 * s);
+        sort3(array, mid - s, mid, mid + s);
+        sort3(array, n - 1 - 2 * s, n - 1 - s, n - 1);
+        sort3(array, s, mid, n - 1 - s);
+    } else {
+        sort3(array, 0, mid, n - 1);
+    }
+    swap_ints(&array[0], &array[mid]);
+}
+
+// Partición de Hoare con el pivote en array[0]; devuelve la posición final del pivote.
+// Ambos índices se detienen en los iguales al pivote, así que muchos repetidos se reparten a la mitad.
+static int partition_hoare(int *array, int n) {
+    int pivot = array[0];
+    int i = 0, j = n;
+    for (;;) {
+        do { i++; } while (i < n && array[i] < pivot);
+        do { j--; } while (array[j] > pivot);
+        if (i >= j) break;
+        swap_ints(&array[i], &array[j]);
+    }
+    swap_ints(&array[0], &array[j]);
+    return j;
+}
+
+static int floor_log2(int n) {
+    int log = 0;
+    while (n >>= 1) log++;
+    return log;
+}
+
+// ================== ORDENAMIENTO MULTIHILO ==================
+
+int local_sort_max_threads(void) {
+    #ifdef _OPENMP
+    return omp_get_max_threads();
+    #else
+    return 1;
+    #endif
+}
+
+void local_sort_parallel(int *array, int n, int threads) {
+    if (threads <= 1 || n <= TASK_CUTOFF) { local_sort(array, n); return; }
+
+    // Buffer auxiliar solo para la partición paralela; sin él se particiona en un solo hilo
+    int *buffer = NULL;
+    if (n >= PARALLEL_PARTITION_MIN) buffer = (int *)malloc((size_t)n * sizeof(int));
+
+    OMP(omp parallel num_threads(threads))
+    OMP(omp single)
+    sort_tasks(array, buffer, n, threads, 2 * floor_log2(n));
+
+    free(buffer);
+}
+
+// Quicksort con tareas: cada partición lanza una tarea para el lado izquierdo y sigue con el derecho.
+// Las tareas las reparte el runtime entre los hilos del equipo, así que el balanceo es dinámico.
+static void sort_tasks(int *array, int *buffer, int n, int threads, int depth_limit) {
+    while (n > TASK_CUTOFF && depth_limit > 0) {
+        depth_limit--;
+
+        choose_pivot(array, n);
+        int pivot = array[0];
+
+        int blocks = (buffer != NULL && n >= PARALLEL_PARTITION_MIN) ? threads : 1;
+        if (blocks > MAX_PARTITION_BLOCKS) blocks = MAX_PARTITION_BLOCKS;
+
+        int low = (blocks > 1) ? partition_parallel(array, buffer, n, pivot, blocks) : partition_le(array, n, pivot);
+        if (low == n) {
+            // Todos son <= pivote: se separan los iguales al pivote (a la derecha) con < pivote.
+            // Si ninguno es menor, todos son iguales y el tramo ya está ordenado.
+            if (pivot == INT_MIN) return;
+            low = (blocks > 1) ? partition_parallel(array, buffer, n, pivot - 1, blocks) : partition_le(array, n, pivot - 1);
+            if (low == 0) return;
+        }
+
+        OMP(omp task firstprivate(array, buffer, low, threads, depth_limit))
+        sort_tasks(array, buffer, low, threads, depth_limit);
+
+        array += low;
+        if (buffer != NULL) buffer += low;
+        n -= low;
+    }
+    local_sort(array, n);
+}
+
+// Partición secuencial in-place; devuelve cuántos quedaron <= pivote (al principio)
+static int partition_le(int *array, int n, int pivot) {
+    int i = 0, j = n - 1;
+    while (i <= j) {
+        if (array[i] <= pivot) i++;
+        else { swap_ints(&array[i], &array[j]); j--; }
+    }
+    return i;
+}
+
+// Partición paralela por bloques: una tarea por bloque cuenta sus elementos <= pivote; con las sumas
+// prefijas cada bloque sabe dónde escribir sus menores y sus mayores en 'buffer', y al final se copia
+// de vuelta. Devuelve cuántos quedaron <= pivote. Mismo resultado que partition_le salvo el orden interno.
+static int partition_parallel(int *array, int *buffer, int n, int pivot, int blocks) {
+    int low_counts[MAX_PARTITION_BLOCKS];
+    int low_offsets[MAX_PARTITION_BLOCKS];
+    int high_offsets[MAX_PARTITION_BLOCKS];
+    int block_size = (n + blocks - 1) / blocks;
+
+    for (int b = 0; b < blocks; b++) {
+        OMP(omp task firstprivate(b) shared(low_counts))
+        {
+            int begin = b * block_size;
+            int end = (begin + block_size < n) ? begin + block_size : n;
+            int count = 0;
+            for (int i = begin; i < end; i++) count += (array[i] <= pivot);
+            low_counts[b] = count;
+        }
+    }
+    OMP(omp taskwait)
+
+    int low_total = 0;
+    for (int b = 0; b < blocks; b++) { low_offsets[b] = low_total; low_total += low_counts[b]; }
+    int high = low_total;
+    for (int b = 0; b < blocks; b++) {
+        int begin = b * block_size;
+        int end = (begin + block_size < n) ? begin + block_size : n;
+        high_offsets[b] = high;
+        if (end > begin) high += (end - begin) - low_counts[b];
+    }
+
+    for (int b = 0; b < blocks; b++) {
+        OMP(omp task firstprivate(b) shared(low_offsets, high_offsets))
+        {
+            int begin = b * block_size;
+            int end = (begin + block_size < n) ? begin + block_size : n;
+            int l = low_offsets[b], h = high_offsets[b];
+            for (int i = begin; i < end; i++) {
+                if (array[i] <= pivot) buffer[l++] = array[i];
+                else buffer[h++] = array[i];
+            }
+        }
+    }
+    OMP(omp taskwait)
+
+    for (int b = 0; b < blocks; b++) {
+        OMP(omp task firstprivate(b))
+        {
+            int begin = b * block_size;
+            int end = (begin + block_size < n) ? begin + block_size : n;
+            if (end > begin) memcpy(array + begin, buffer + begin, (size_t)(end - begin) * sizeof(int));
+        }
+    }
+    OMP(omp taskwait)
+
+    return low_total;
+}
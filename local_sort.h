@@ -0,0 +1,34 @@
+#ifndef LOCAL_SORT_H
+#define LOCAL_SORT_H
+
+// Ordenamiento en memoria de un solo nodo (sin MPI): introsort secuencial y una versión
+// multihilo con OpenMP. Es la referencia "una máquina bien aprovechada" contra la que se mide
+// la versión distribuida.
+// compilar ' gcc -fopenmp mi_programa.c local_sort.c -o mi_programa -O3 '
+// (sin -fopenmp compila igual y local_sort_parallel se vuelve secuencial)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Introsort de enteros in-place: quicksort con mediana de 3 (de 9 en tramos grandes),
+ *        inserción para tramos cortos y heapsort si la recursión se degenera. O(n log n) en el peor caso.
+ */
+void local_sort(int *array, int n);
+
+/**
+ * @brief Ordenamiento multihilo in-place con hasta 'threads' hilos: partición paralela por bloques
+ *        en los tramos grandes y recursión con tareas de OpenMP; los tramos chicos usan local_sort.
+ *        Con 'threads' <= 1 equivale a local_sort.
+ */
+void local_sort_parallel(int *array, int n, int threads);
+
+/** @brief Hilos disponibles (omp_get_max_threads, o 1 si se compiló sin OpenMP). */
+int local_sort_max_threads(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOCAL_SORT_H
@@ -0,0 +1,47 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "parallel_sort.h"
+#include "parallel_tune.h"
+
+// Ajuste automático: corre los micro-benchmarks con la misma cantidad de procesos (y la misma
+// distribución en nodos) que se va a usar después, y guarda los parámetros derivados en un archivo
+// que parallel_quicksortV2 y batch_quicksort cargan al arrancar.
+// compilar ' mpicc parallel_autotune.c parallel_sort.c parallel_tune.c local_sort.c text_reader.c -o parallel_autotune -O3 -lm '
+// ejecutar ' mpirun -np 8 ./parallel_autotune [archivo_de_parametros] [clave=valor ...] '
+//   los "clave=valor" fijan un parámetro por encima de lo que derive el ajuste
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    const char *path = PSORT_TUNING_FILE;
+    if (argc > 1 && !psort_tuning_is_assignment(argv[1])) path = argv[1];
+
+    PSortTuning tuning;
+    PSortBenchmark bench;
+    double start_time = MPI_Wtime();
+    int status = psort_autotune(MPI_COMM_WORLD, &tuning, &bench, world_rank == 0 ? stdout : NULL);
+    double end_time = MPI_Wtime();
+
+    // Los valores fijados a mano se aplican al final; solo el raíz escribe el archivo
+    if (world_rank == 0) {
+        for (int i = 1; i < argc && status == PSORT_OK; i++) {
+            if (psort_tuning_is_assignment(argv[i])) status = psort_tuning_set(&tuning, argv[i]);
+        }
+    }
+
+    if (world_rank == 0 && status == PSORT_OK) {
+        printf("\n--- Parámetros derivados ---\n");
+        psort_tuning_log(&tuning, stdout);
+        status = psort_tuning_save(path, &tuning, &bench);
+        if (status == PSORT_OK) printf("Guardados en %s\n", path);
+        printf("Tiempo de ajuste: %f segundos\n", end_time - start_time);
+    }
+
+    MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return (status == PSORT_OK) ? 0 : 1;
+}
@@ -2,13 +2,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <string.h> // Para memcpy
-
-// --- Prototipos de Funciones ---
-int compare_integers(const void *a, const void *b);
-bool is_prime(int n);
-int partition_inplace(int *array, int n, int pivot);
-void parallel_quicksort(int **local_array, int *local_n, MPI_Comm comm);
+#include "parallel_sort.h" // Quicksort paralelo: compilar junto con parallel_sort.c, local_sort.c y text_reader.c
+#include "parallel_stats.h" // Análisis posterior (primos, distintos, ...): compilar junto con parallel_stats.c y primes.c
+#include "parallel_tune.h"  // Parámetros por máquina (psort_tuning.conf y clave=valor): compilar junto con parallel_tune.c
 
 // --- Función Principal ---
 int main(int argc, char **argv) {
@@ -17,39 +13,47 @@ int main(int argc, char **argv) {
     int world_rank, world_size;
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    if (world_rank == 0 && (argc < 2 || psort_tuning_is_assignment(argv[1]))) {
+        fprintf(stderr, "Uso: %s <archivo_de_entrada> [clave=valor ...]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // Parámetros: valores por defecto, luego PSORT_TUNING_FILE (generado por parallel_autotune, si existe)
+    // y por último los "clave=valor" de la línea de comandos
+    PSortTuning tuning;
+    if (psort_tuning_setup(MPI_COMM_WORLD, PSORT_TUNING_FILE, argc, argv, &tuning) != PSORT_OK) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
     
+    // El tiempo medido incluye la lectura del archivo: con la distribución en streaming la lectura y el
+    // ordenamiento de los bloques se solapan, y la referencia secuencial también mide su lectura
     double start_time, end_time;
     MPI_Barrier(MPI_COMM_WORLD); 
     start_time = MPI_Wtime();
 
+    PSortContext *ctx = psort_create_tuned(MPI_COMM_WORLD, &tuning);
+    if (!ctx) {
+        if (world_rank == 0) fprintf(stderr, "No se pudo crear el contexto: el número de procesos (%d) debe ser potencia de 2.\n", world_size);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
     int N = 0; 
     int *global_array = NULL;
+    int local_n = 0;
+    int *local_array = NULL;
 
+    #if defined(DEBUG_PRINT) || defined(FULL_SCATTER)
+    // Lectura completa en el raíz + MPI_Scatter (hace falta el arreglo entero para imprimirlo)
     if (world_rank == 0) {
-        if (argc != 2) {
-            fprintf(stderr, "Uso: %s <archivo_de_entrada>\n", argv[0]);
-            MPI_Abort(MPI_COMM_WORLD, 1);
-        }
-
-        FILE *file = fopen(argv[1], "r");
-        if (!file) {
-            perror("Error abriendo el archivo");
+        if (psort_read_file(argv[1], &global_array, &N) != PSORT_OK) {
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
-
-        // Leer N y los datos desde el archivo
-        fscanf(file, "%d", &N);
         if (N % world_size != 0) {
             fprintf(stderr, "N (%d) debe ser divisible por el número de procesos (%d).\n", N, world_size);
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
 
-        global_array = (int *)malloc(N * sizeof(int));
-        for (int i = 0; i < N; i++) {
-            fscanf(file, "%d", &global_array[i]);
-        }
-        fclose(file);
-
         #ifdef DEBUG_PRINT
         printf("Arreglo original (N=%d) leído desde %s:\n", N, argv[1]);
         for (int i = 0; i < N; i++) { printf("%d ", global_array[i]); }
@@ -59,27 +63,48 @@ int main(int argc, char **argv) {
         #endif
     }
     
-    MPI_Bcast(&N, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    int local_n = N / world_size;
-    int *local_array = (int *)malloc(local_n * sizeof(int));
-
-    MPI_Scatter(global_array, local_n, MPI_INT, local_array, local_n, MPI_INT, 0, MPI_COMM_WORLD);
+    psort_scatter(ctx, global_array, &N, &local_array, &local_n);
     
     if (world_rank == 0) {
         free(global_array);
         global_array = NULL;
     }
+    #else
+    // Distribución en streaming: el raíz lee y envía por bloques sin tener nunca los N números,
+    // y los demás ordenan cada bloque al recibirlo (compilar con -DFULL_SCATTER para el reparto clásico)
+    if (psort_stream_file(ctx, argv[1], &N, &local_array, &local_n) != PSORT_OK) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (world_rank == 0) {
+        printf("Arreglo original (N=%d) leído desde %s.\n", N, argv[1]);
+    }
+    #endif
 
     // --- Algoritmo principal ---
-    parallel_quicksort(&local_array, &local_n, MPI_COMM_WORLD);
-
-    // ... (El resto de la lógica de conteo de primos y recolección no cambia) ...
-    int local_prime_count = 0;
-    for (int i = 0; i < local_n; i++) { if (is_prime(local_array[i])) local_prime_count++; }
-    
-    int total_prime_count = 0;
-    MPI_Reduce(&local_prime_count, &total_prime_count, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Una sonda barata elige la estrategia (hipercubo, juntar en el raíz, conteo, solo local o nada).
+    // Compilar con -DFORCE_HYPERCUBE para medir siempre el quicksort en hipercubo.
+    PSortPlan plan;
+    #if defined(DEBUG_PRINT) || defined(FULL_SCATTER)
+    plan.sorted_slices = 0;
+    #else
+    plan.sorted_slices = 1; // psort_stream_file entrega cada tramo ya ordenado
+    #endif
+    #ifdef FORCE_HYPERCUBE
+    plan.strategy = PSORT_STRATEGY_HYPERCUBE;
+    psort_sort(ctx, &local_array, &local_n);
+    #else
+    psort_sort_auto(ctx, &local_array, &local_n, &plan);
+    #endif
+
+    // ================== ANÁLISIS FUSIONADO ==================
+    // Primos, distintos, suma, histograma y rango en una sola pasada por el tramo ordenado
+    // y un solo MPI_Reduce. El histograma cubre el rango que ya midió la sonda del plan.
+    PSortStats stats;
+    #ifdef FORCE_HYPERCUBE
+    psort_stats(ctx, local_array, local_n, PSORT_STATS_ALL, 1, 0, &stats);
+    #else
+    psort_stats(ctx, local_array, local_n, PSORT_STATS_ALL, plan.min_value, plan.max_value, &stats);
+    #endif
     
     // // ================== CÁLCULO DE BALANCEO DE CARGA ==================
     // // Medimos cómo se distribuyeron los elementos al final del ordenamiento.
@@ -96,30 +121,23 @@ int main(int argc, char **argv) {
     // // =================================================================
 
 
-    int *recv_counts = NULL;
-    int *displacements = NULL;
-    if (world_rank == 0) {
-        recv_counts = (int *)malloc(world_size * sizeof(int));
-        displacements = (int *)malloc(world_size * sizeof(int));
-    }
-
-    MPI_Gather(&local_n, 1, MPI_INT, recv_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    
     if (world_rank == 0) {
         global_array = (int *)malloc(N * sizeof(int));
-        displacements[0] = 0;
-        for (int i = 1; i < world_size; i++) {
-            displacements[i] = displacements[i - 1] + recv_counts[i - 1];
-        }
     }
     
-    MPI_Gatherv(local_array, local_n, MPI_INT, global_array, recv_counts, displacements, MPI_INT, 0, MPI_COMM_WORLD);
+    psort_gather(ctx, local_array, local_n, global_array);
     
     MPI_Barrier(MPI_COMM_WORLD); 
     end_time = MPI_Wtime();
 
     if (world_rank == 0) {
         printf("\n--- Resultados ---\n");
+        #ifdef FORCE_HYPERCUBE
+        printf("Plan: %s (forzado)\n", psort_strategy_name(plan.strategy));
+        #else
+        psort_plan_log(&plan, stdout);
+        #endif
+        psort_tuning_log(&tuning, stdout);
         #ifdef DEBUG_PRINT
         printf("Arreglo ordenado:\n");
         for (int i = 0; i < N; i++) { printf("%d ", global_array[i]); }
@@ -127,7 +145,7 @@ int main(int argc, char **argv) {
         #else
         printf("Arreglo ordenado correctamente.\n");
         #endif
-        printf("Total de números primos encontrados: %d\n", total_prime_count);
+        psort_stats_log(&stats, stdout);
         printf("Tiempo de ejecución total: %f segundos\n", end_time - start_time);
 
         // // Imprimir estadísticas de balanceo de carga
@@ -139,143 +157,10 @@ int main(int argc, char **argv) {
         // }
         
         free(global_array);
-        free(recv_counts);
-        free(displacements);
     }
     
     free(local_array);
+    psort_destroy(ctx);
     MPI_Finalize();
     return 0;
-}
-
-
-// --- Implementación de Quick Sort Paralelo Mejorado ---
-void parallel_quicksort(int **local_array_ptr, int *local_n_ptr, MPI_Comm comm) {
-    int comm_rank, comm_size;
-    MPI_Comm_rank(comm, &comm_rank);
-    MPI_Comm_size(comm, &comm_size);
-    int local_n = *local_n_ptr;
-    int *local_array = *local_array_ptr;
-
-    if (comm_size < 2) {
-        if (local_n > 0) qsort(local_array, local_n, sizeof(int), compare_integers);
-        return;
-    }
-
-    // ================== MEJORA 1: PIVOTE POR MEDIANA DE MEDIANOS ==================
-    int pivot = 0;
-    // 1. Cada proceso calcula su mediana local
-    int local_median = 0;
-    if (local_n > 0) {
-        qsort(local_array, local_n, sizeof(int), compare_integers);
-        local_median = local_array[local_n / 2];
-    }
-
-    // 2. El líder del grupo recolecta todas las medianas locales
-    int *medians = NULL;
-    if (comm_rank == 0) {
-        medians = (int *)malloc(comm_size * sizeof(int));
-    }
-    MPI_Gather(&local_median, 1, MPI_INT, medians, 1, MPI_INT, 0, comm);
-
-    // 3. El líder calcula la mediana de las medianas (el pivote final)
-    if (comm_rank == 0) {
-        qsort(medians, comm_size, sizeof(int), compare_integers);
-        pivot = medians[comm_size / 2];
-        free(medians);
-    }
-
-    // 4. El líder transmite el pivote robusto a todos
-    MPI_Bcast(&pivot, 1, MPI_INT, 0, comm);
-    // =============================================================================
-
-    // ================== MEJORA 2: PARTICIÓN IN-PLACE ==================
-    // No se crean nuevos arreglos 'less' y 'greater', ahorrando memoria.
-    int split_point = partition_inplace(local_array, local_n, pivot);
-    int less_count = split_point;
-    int greater_count = local_n - split_point;
-    // =================================================================
-
-    // ================== MEJORA 3: INTERCAMBIO CON MPI_Sendrecv ==================
-    // Esto previene deadlocks con mensajes grandes.
-    int partner_rank;
-    int color = (comm_rank < comm_size / 2) ? 0 : 1;
-    
-    int *incoming_buffer = NULL;
-    int incoming_count = 0;
-
-    if (color == 0) { // Grupo bajo: envía 'greater', recibe 'less' | bajo quiere deshacerse de sus números > pivot y recibir los números ≤ pivot del grupo alto.
-        partner_rank = comm_rank + (comm_size / 2);
-        // Primero, averigua cuántos datos vas a recibir
-        MPI_Sendrecv(&greater_count, 1, MPI_INT, partner_rank, 0, 
-                     &incoming_count, 1, MPI_INT, partner_rank, 0, comm, MPI_STATUS_IGNORE);
-
-        incoming_buffer = (int *)malloc(incoming_count * sizeof(int));
-        
-        // Ahora, intercambia los datos
-        MPI_Sendrecv(local_array + less_count, greater_count, MPI_INT, partner_rank, 1,
-                     incoming_buffer, incoming_count, MPI_INT, partner_rank, 1, comm, MPI_STATUS_IGNORE);
-        
-        // Combina tus datos 'less' con los recibidos
-        *local_array_ptr = (int *)realloc(local_array, (less_count + incoming_count) * sizeof(int));
-        memcpy(*local_array_ptr + less_count, incoming_buffer, incoming_count * sizeof(int));
-        *local_n_ptr = less_count + incoming_count;
-
-            // sugerencia de usar malloc() en vez de realloc 
-            // Usamos la misma lógica que el grupo 'alto' para consistencia y seguridad.
-
-        // int *new_local_array = (int *)malloc((less_count + incoming_count) * sizeof(int));
-        // memcpy(new_local_array, local_array, less_count * sizeof(int)); // Copia los 'less' propios
-        // memcpy(new_local_array + less_count, incoming_buffer, incoming_count * sizeof(int)); // Copia los 'less' recibidos
-        
-        // free(*local_array_ptr);
-        // *local_array_ptr = new_local_array;
-        // *local_n_ptr = less_count + incoming_count;
-
-    } else { // Grupo alto: envía 'less', recibe 'greater' | alto quiere deshacerse de sus números ≤ pivot y recibir los números > pivot del grupo bajo
-        partner_rank = comm_rank - (comm_size / 2);
-        MPI_Sendrecv(&less_count, 1, MPI_INT, partner_rank, 0, 
-                     &incoming_count, 1, MPI_INT, partner_rank, 0, comm, MPI_STATUS_IGNORE);
-
-        incoming_buffer = (int *)malloc(incoming_count * sizeof(int));
-
-        MPI_Sendrecv(local_array, less_count, MPI_INT, partner_rank, 1,
-                     incoming_buffer, incoming_count, MPI_INT, partner_rank, 1, comm, MPI_STATUS_IGNORE);
-
-        // Combina tus datos 'greater' con los recibidos
-        int *new_local_array = (int *)malloc((greater_count + incoming_count) * sizeof(int));
-        memcpy(new_local_array, local_array + less_count, greater_count * sizeof(int));
-        memcpy(new_local_array + greater_count, incoming_buffer, incoming_count * sizeof(int));
-        
-        free(*local_array_ptr);
-        *local_array_ptr = new_local_array;
-        *local_n_ptr = greater_count + incoming_count;
-    }
-    free(incoming_buffer);
-    // =============================================================================
-
-    MPI_Comm new_comm;
-    MPI_Comm_split(comm, color, comm_rank, &new_comm);
-    parallel_quicksort(local_array_ptr, local_n_ptr, new_comm);
-    MPI_Comm_free(&new_comm);
-}
-
-// --- Funciones Auxiliares ---
-
-// Particiona un arreglo in-place y devuelve el número de elementos <= pivote
-int partition_inplace(int *array, int n, int pivot) {
-    int i = 0, j = n - 1;
-    while (i <= j) {
-        while (i < n && array[i] <= pivot) { i++; }
-        while (j >= 0 && array[j] > pivot) { j--; }
-        if (i < j) {
-            int temp = array[i];
-            array[i] = array[j];
-            array[j] = temp;
-        }
-    }
-    return i;
-}
-
-int compare_integers(const void *a, const void *b) { return (*(int *)a - *(int *)b); }
-bool is_prime(int n) { if (n <= 1) return false; for (int i = 2; i * i <= n; i++) { if (n % i == 0) return false; } return true; }
\ No newline at end of file
+}
\ No newline at end of file
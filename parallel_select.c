@@ -0,0 +1,170 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_sort.h"
+#include "parallel_tune.h"
+
+// Selección distribuida: mediana, cuantiles, k-ésimo elemento o top-k sin ordenar todo el arreglo.
+// compilar ' mpicc parallel_select.c parallel_sort.c parallel_tune.c local_sort.c text_reader.c -o parallel_select -O3 -lm '
+// algunas ejecuciones
+// ' mpirun -np 4 ./parallel_select numeros32768.txt mediana '
+// ' mpirun -np 4 ./parallel_select numeros32768.txt cuantiles 0.25,0.5,0.9,0.99 '
+// ' mpirun -np 4 ./parallel_select numeros32768.txt kesimo 1000 '   (rango global desde 0)
+// ' mpirun -np 4 ./parallel_select numeros32768.txt top 1000 '
+// como en parallel_quicksortV2, cualquier parámetro de psort_tuning.conf se puede fijar con ' clave=valor '
+
+#define MAX_QUANTILES 64
+#define TOP_K_PRINT_LIMIT 10 // Valores del top-k que se muestran (todos con -DDEBUG_PRINT)
+
+// --- Prototipos de Funciones ---
+static void print_usage_and_abort(const char *prog_name);
+static int parse_quantiles(const char *list, double *quantiles);
+
+// --- Función Principal ---
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int world_rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    // Argumentos posicionales (archivo, modo y valor), salteando los "clave=valor" en cualquier lugar
+    const char *args[3] = { NULL, NULL, NULL };
+    int arg_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (psort_tuning_is_assignment(argv[i])) continue;
+        if (arg_count == 3) print_usage_and_abort(argv[0]);
+        args[arg_count++] = argv[i];
+    }
+    if (arg_count < 2) print_usage_and_abort(argv[0]);
+    const char *path = args[0];
+    const char *mode = args[1];
+    const char *value = args[2];
+    if ((strcmp(mode, "mediana") == 0) != (value == NULL)) print_usage_and_abort(argv[0]);
+
+    // Parámetros de PSORT_TUNING_FILE (si existe) con los "clave=valor" de la línea de comandos encima
+    PSortTuning tuning;
+    if (psort_tuning_setup(MPI_COMM_WORLD, PSORT_TUNING_FILE, argc, argv, &tuning) != PSORT_OK) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    double start_time, end_time;
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_time = MPI_Wtime();
+
+    PSortContext *ctx = psort_create_tuned(MPI_COMM_WORLD, &tuning);
+    if (!ctx) {
+        if (world_rank == 0) fprintf(stderr, "No se pudo crear el contexto: el número de procesos (%d) debe ser potencia de 2.\n", world_size);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    int N = 0;
+    int *global_array = NULL;
+
+    if (world_rank == 0) {
+        if (psort_read_file(path, &global_array, &N) != PSORT_OK) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (N % world_size != 0) {
+            fprintf(stderr, "N (%d) debe ser divisible por el número de procesos (%d).\n", N, world_size);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        printf("Arreglo original (N=%d) leído desde %s.\n", N, path);
+    }
+
+    int local_n = 0;
+    int *local_array = NULL;
+    psort_scatter(ctx, global_array, &N, &local_array, &local_n);
+
+    if (world_rank == 0) {
+        free(global_array);
+        global_array = NULL;
+    }
+
+    // --- Selección ---
+    int status = PSORT_OK;
+    int count = 0;
+    double quantiles[MAX_QUANTILES];
+    int values[MAX_QUANTILES];
+    long long rank_k = 0;
+    int *top = NULL;
+
+    if (strcmp(mode, "mediana") == 0) {
+        quantiles[0] = 0.5;
+        count = 1;
+        status = psort_quantiles(ctx, local_array, local_n, quantiles, count, values);
+    } else if (strcmp(mode, "cuantiles") == 0) {
+        count = parse_quantiles(value, quantiles);
+        status = psort_quantiles(ctx, local_array, local_n, quantiles, count, values);
+    } else if (strcmp(mode, "kesimo") == 0) {
+        rank_k = atoll(value);
+        status = psort_select(ctx, local_array, local_n, &rank_k, 1, values);
+    } else if (strcmp(mode, "top") == 0) {
+        count = atoi(value);
+        if (world_rank == 0 && count > 0) top = (int *)malloc(count * sizeof(int));
+        status = psort_top_k(ctx, local_array, local_n, count, top);
+    } else {
+        print_usage_and_abort(argv[0]);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    end_time = MPI_Wtime();
+
+    if (world_rank == 0) {
+        printf("\n--- Resultados ---\n");
+        if (status != PSORT_OK) {
+            printf("Error: parámetro fuera de rango para N=%d.\n", N);
+        } else if (strcmp(mode, "kesimo") == 0) {
+            printf("Elemento de rango %lld: %d\n", rank_k, values[0]);
+        } else if (strcmp(mode, "top") == 0) {
+            int shown = count;
+            #ifndef DEBUG_PRINT
+            if (shown > TOP_K_PRINT_LIMIT) shown = TOP_K_PRINT_LIMIT;
+            #endif
+            printf("Top %d (mostrando %d):", count, shown);
+            for (int i = 0; i < shown; i++) { printf(" %d", top[i]); }
+            printf("\n");
+        } else {
+            for (int i = 0; i < count; i++) { printf("Cuantil %.4f: %d\n", quantiles[i], values[i]); }
+        }
+        psort_tuning_log(&tuning, stdout);
+        printf("Tiempo de ejecución total: %f segundos\n", end_time - start_time);
+    }
+
+    free(top);
+    free(local_array);
+    psort_destroy(ctx);
+    MPI_Finalize();
+    return 0;
+}
+
+// --- Funciones Auxiliares ---
+
+static void print_usage_and_abort(const char *prog_name) {
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    if (world_rank == 0) {
+        fprintf(stderr, "Uso: %s <archivo_de_entrada> <modo> [valor] [clave=valor ...]\n", prog_name);
+        fprintf(stderr, "Modos:\n");
+        fprintf(stderr, "  mediana                 Mediana global.\n");
+        fprintf(stderr, "  cuantiles <q1,q2,...>   Cuantiles entre 0 y 1 (máximo %d).\n", MAX_QUANTILES);
+        fprintf(stderr, "  kesimo <k>              Elemento de rango global k (0 = el menor).\n");
+        fprintf(stderr, "  top <k>                 Los k mayores valores, de mayor a menor.\n");
+    }
+    MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+// Convierte "0.25,0.5,0.9" en un arreglo de cuantiles; devuelve cuántos leyó
+static int parse_quantiles(const char *list, double *quantiles) {
+    int count = 0;
+    const char *p = list;
+    while (*p && count < MAX_QUANTILES) {
+        char *end;
+        double q = strtod(p, &end);
+        if (end == p) break;
+        quantiles[count++] = q;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
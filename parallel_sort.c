@@ -0,0 +1,1226 @@
+#include "parallel_sort.h"
+#include "local_sort.h" // Introsort para los ordenamientos locales: compilar junto con local_sort.c
+#include "text_reader.h" // Lector de enteros de la distribución en streaming: compilar junto con text_reader.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h> // Para memcpy
+#include <limits.h>
+
+// Intercambio por memoria compartida entre socios del mismo nodo (compilar con -DUSE_SHARED_EXCHANGE=0 para desactivarlo)
+#ifndef USE_SHARED_EXCHANGE
+#define USE_SHARED_EXCHANGE 1
+#endif
+
+// Selección: cuando quedan pocos candidatos en total se juntan en todos los procesos y se resuelven localmente
+#ifndef SELECT_GATHER_THRESHOLD
+#define SELECT_GATHER_THRESHOLD 4096
+#endif
+
+// Compresión de tramos ordenados (delta + varint) en los intercambios por mensajes y en psort_gather
+// (compilar con -DUSE_COMPRESSION=0 para desactivarla). Solo se activa si la relación estimada lo justifica.
+#ifndef USE_COMPRESSION
+#define USE_COMPRESSION 1
+#endif
+#ifndef COMPRESS_MIN_COUNT
+#define COMPRESS_MIN_COUNT 4096        // Por defecto: tramos más chicos no compensan el costo de codificar
+#endif
+#ifndef COMPRESS_MIN_RATIO
+#define COMPRESS_MIN_RATIO 1.5         // Bytes crudos / bytes codificados mínimos para usar el códec
+#endif
+
+// Distribución en streaming: tamaño de bloque por defecto (en enteros) y etiqueta de sus mensajes
+#ifndef STREAM_BLOCK_SIZE
+#define STREAM_BLOCK_SIZE 65536
+#endif
+#define STREAM_TAG 2
+#define GATHER_TAG 3                   // Tramos de psort_gather comprimido
+
+// Planificación: umbrales de la sonda y de la elección de estrategia
+#ifndef PLAN_GATHER_MAX_N
+#define PLAN_GATHER_MAX_N 65536        // Por defecto: hasta este N conviene juntar y ordenar en un solo proceso
+#endif
+#ifndef PLAN_COUNTING_MAX_RANGE
+#define PLAN_COUNTING_MAX_RANGE (1 << 20) // Rango máximo (max - min + 1) para el ordenamiento por conteo
+#endif
+// Valores por defecto del resto de los parámetros ajustables (ver PSortTuning)
+#ifndef PIVOT_SAMPLES
+#define PIVOT_SAMPLES 1                // Solo la mediana local: la mediana de medianas clásica
+#endif
+#ifndef LOCAL_SORT_ALGORITHM
+#define LOCAL_SORT_ALGORITHM PSORT_LOCAL_INTROSORT
+#endif
+#ifndef RANKS_PER_NODE
+#define RANKS_PER_NODE 0               // Todos los procesos del nodo comparten memoria
+#endif
+
+#define PLAN_SUMMARY_FIELDS 6          // tiene datos, primero, último, mínimo, máximo, descensos
+
+// Un nivel del hipercubo. Se calcula una sola vez en psort_create y se reutiliza en cada ordenamiento.
+typedef struct {
+    MPI_Comm comm;          // Comunicador del nivel
+    MPI_Comm node_comm;     // Procesos de 'comm' en el mismo nodo (MPI_COMM_NULL si no se usa)
+    int rank, size;
+    int color;              // 0: grupo bajo, 1: grupo alto
+    int partner;            // Socio del intercambio dentro de 'comm'
+    int partner_node_rank;  // Rango del socio en 'node_comm' (MPI_UNDEFINED si está en otro nodo)
+    int any_local_partner;  // Algún proceso del nodo tiene su socio en el nodo: se crea ventana compartida
+
+    // Ventana compartida del nivel: se crea la primera vez que hace falta y se reutiliza en cada ordenamiento
+    MPI_Win win;            // MPI_WIN_NULL hasta el primer intercambio por memoria compartida
+    int *segment;           // Mi segmento de 'win'
+    int *partner_segment;   // Segmento del socio (NULL si está en otro nodo)
+    MPI_Aint capacity;      // Enteros que entran en 'segment'
+} PSortLevel;
+
+struct PSortContext {
+    MPI_Comm comm;          // Duplicado del comunicador del usuario
+    int rank, size;
+    PSortTuning tuning;
+    PSortLevel *levels;     // levels[num_levels - 1] tiene un solo proceso (caso base)
+    int num_levels;
+
+    // Buffers reutilizados entre niveles y entre llamadas
+    int *medians;           // Pares (muestra, peso) recolectados por el líder de cada nivel
+    void *incoming;         // Datos recibidos por mensajes (enteros o bytes codificados)
+    size_t incoming_capacity;
+    unsigned char *encoded; // Tramo saliente codificado
+    size_t encoded_capacity;
+    int *gather_headers;    // Pares (cantidad, bytes codificados) para psort_gather comprimido
+    MPI_Request *requests;  // Recepciones de psort_gather comprimido (una por proceso)
+    int *recv_counts;       // Conteos y desplazamientos para psort_gather
+    int *displacements;
+    int *summaries;         // Resúmenes de todos los procesos para psort_plan
+};
+
+// Un rango global buscado por la selección y la posición de su resultado en el arreglo del usuario
+typedef struct {
+    long long rank;
+    int index;
+} SelectTarget;
+
+// --- Prototipos de Funciones Internas ---
+static void exchange_level(PSortContext *ctx, PSortLevel *lv, int **local_array, int *local_n, bool *in_window);
+static int *reserve_level_window(PSortLevel *lv, int needed);
+static int median_of_medians(PSortContext *ctx, MPI_Comm comm, const int *pairs, int pair_count);
+static void sort_local(const PSortContext *ctx, int *array, int n);
+static void *reserve_buffer(void **buffer, size_t *capacity, size_t bytes);
+static int stream_blocks_from_root(PSortContext *ctx, TextReader *reader, int N, int *own_array, int own_n, int *blocks[2]);
+static void receive_stream_blocks(PSortContext *ctx, int *local_array, int local_n);
+static void merge_sorted_blocks(int *array, int n, int run, int *buffer);
+#if USE_COMPRESSION
+static int gather_encoded(PSortContext *ctx, const int *local_array, int local_n, int local_bytes, int max_bytes, int *global_array);
+static int encode_sorted_run(const int *values, int count, unsigned char *out, int capacity);
+#endif
+static int encode_if_worthwhile(PSortContext *ctx, const int *values, int count);
+static void decode_sorted_run(const unsigned char *in, int count, int *out);
+static int sort_on_root(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n);
+static int counting_sort(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n);
+static void select_range(PSortContext *ctx, int *array, int lo, int hi, long long base, SelectTarget *targets, int count, int *values);
+static void partition3(int *array, int n, int pivot, int *less_count, int *less_equal_count);
+static int local_select(int *array, int n, int k);
+static int compare_targets(const void *a, const void *b);
+static int compare_median_pairs(const void *a, const void *b);
+#if USE_SHARED_EXCHANGE
+static int node_rank_of(MPI_Comm comm, MPI_Comm node_comm, int rank);
+#endif
+static int agree_status(PSortContext *ctx, int status);
+static void free_context_buffers(PSortContext *ctx);
+
+// --- Contexto ---
+
+void psort_tuning_defaults(PSortTuning *tuning) {
+    tuning->pivot_samples = PIVOT_SAMPLES;
+    tuning->gather_max_n = PLAN_GATHER_MAX_N;
+    tuning->stream_block_size = STREAM_BLOCK_SIZE;
+    tuning->compress_min_count = COMPRESS_MIN_COUNT;
+    tuning->local_sort = LOCAL_SORT_ALGORITHM;
+    tuning->ranks_per_node = RANKS_PER_NODE;
+}
+
+PSortContext *psort_create(MPI_Comm comm) {
+    PSortTuning tuning;
+    psort_tuning_defaults(&tuning);
+    return psort_create_tuned(comm, &tuning);
+}
+
+PSortContext *psort_create_tuned(MPI_Comm comm, const PSortTuning *tuning) {
+    // El árbol de niveles parte cada comunicador en dos mitades iguales: con otro tamaño los socios no
+    // coinciden y el intercambio se bloquea. El tamaño es el mismo en todos, así que todos devuelven NULL.
+    int comm_size;
+    MPI_Comm_size(comm, &comm_size);
+    if (comm_size & (comm_size - 1)) return NULL;
+
+    PSortTuning clamped = *tuning;
+    if (clamped.pivot_samples < 1) clamped.pivot_samples = 1;
+    if (clamped.pivot_samples > PSORT_MAX_PIVOT_SAMPLES) clamped.pivot_samples = PSORT_MAX_PIVOT_SAMPLES;
+    if (clamped.stream_block_size < 1) clamped.stream_block_size = STREAM_BLOCK_SIZE;
+    if (clamped.compress_min_count < 1) clamped.compress_min_count = 1; // El códec lee el primer y el último valor
+
+    // Todas las reservas antes de la primera colectiva propia; un fallo en cualquier proceso se
+    // acuerda sobre 'comm' y todos devuelven NULL en lugar de quedar esperando en MPI_Comm_dup
+    int max_levels = 1;
+    for (int s = comm_size; s > 1; s /= 2) max_levels++;
+    PSortContext *ctx = (PSortContext *)calloc(1, sizeof(PSortContext));
+    bool allocated = (ctx != NULL);
+    if (allocated) {
+        ctx->levels = (PSortLevel *)malloc(max_levels * sizeof(PSortLevel));
+        ctx->medians = (int *)malloc(2 * comm_size * clamped.pivot_samples * sizeof(int));
+        ctx->recv_counts = (int *)malloc(comm_size * sizeof(int));
+        ctx->displacements = (int *)malloc(comm_size * sizeof(int));
+        ctx->gather_headers = (int *)malloc(2 * comm_size * sizeof(int));
+        ctx->requests = (MPI_Request *)malloc(comm_size * sizeof(MPI_Request));
+        ctx->summaries = (int *)malloc(comm_size * PLAN_SUMMARY_FIELDS * sizeof(int));
+        allocated = ctx->levels && ctx->medians && ctx->recv_counts && ctx->displacements &&
+                    ctx->gather_headers && ctx->requests && ctx->summaries;
+    }
+    int all_allocated = 0, local_allocated = allocated;
+    MPI_Allreduce(&local_allocated, &all_allocated, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_allocated) {
+        free_context_buffers(ctx);
+        return NULL;
+    }
+
+    ctx->tuning = clamped;
+
+    MPI_Comm_dup(comm, &ctx->comm);
+    MPI_Comm_rank(ctx->comm, &ctx->rank);
+    MPI_Comm_size(ctx->comm, &ctx->size);
+
+    // Se construye el árbol de sub-comunicadores una sola vez (antes se hacía un MPI_Comm_split por nivel y por llamada)
+    MPI_Comm level_comm;
+    MPI_Comm_dup(ctx->comm, &level_comm);
+    while (true) {
+        PSortLevel *lv = &ctx->levels[ctx->num_levels++];
+        lv->comm = level_comm;
+        MPI_Comm_rank(lv->comm, &lv->rank);
+        MPI_Comm_size(lv->comm, &lv->size);
+        lv->node_comm = MPI_COMM_NULL;
+        lv->partner_node_rank = MPI_UNDEFINED;
+        lv->any_local_partner = 0;
+        lv->win = MPI_WIN_NULL;
+        lv->segment = lv->partner_segment = NULL;
+        lv->capacity = 0;
+        if (lv->size < 2) break;
+
+        lv->color = (lv->rank < lv->size / 2) ? 0 : 1;
+        lv->partner = (lv->color == 0) ? lv->rank + (lv->size / 2) : lv->rank - (lv->size / 2);
+
+#if USE_SHARED_EXCHANGE
+        MPI_Comm_split_type(lv->comm, MPI_COMM_TYPE_SHARED, lv->rank, MPI_INFO_NULL, &lv->node_comm);
+        if (ctx->tuning.ranks_per_node > 0) {
+            // Grupos de 'ranks_per_node' procesos consecutivos dentro del nodo (nunca más allá del nodo real)
+            MPI_Comm group_comm;
+            MPI_Comm_split(lv->node_comm, ctx->rank / ctx->tuning.ranks_per_node, lv->rank, &group_comm);
+            MPI_Comm_free(&lv->node_comm);
+            lv->node_comm = group_comm;
+        }
+        lv->partner_node_rank = node_rank_of(lv->comm, lv->node_comm, lv->partner);
+        int has_local_partner = (lv->partner_node_rank != MPI_UNDEFINED);
+        MPI_Allreduce(&has_local_partner, &lv->any_local_partner, 1, MPI_INT, MPI_LOR, lv->node_comm);
+#endif
+
+        MPI_Comm_split(lv->comm, lv->color, lv->rank, &level_comm);
+    }
+    return ctx;
+}
+
+void psort_destroy(PSortContext *ctx) {
+    if (!ctx) return;
+    for (int l = 0; l < ctx->num_levels; l++) {
+        if (ctx->levels[l].win != MPI_WIN_NULL) MPI_Win_free(&ctx->levels[l].win);
+        if (ctx->levels[l].node_comm != MPI_COMM_NULL) MPI_Comm_free(&ctx->levels[l].node_comm);
+        MPI_Comm_free(&ctx->levels[l].comm);
+    }
+    MPI_Comm_free(&ctx->comm);
+    free_context_buffers(ctx);
+}
+
+// Libera la memoria del contexto (no toca comunicadores ni ventanas). Acepta un contexto a medio reservar.
+static void free_context_buffers(PSortContext *ctx) {
+    if (!ctx) return;
+    free(ctx->levels);
+    free(ctx->medians);
+    free(ctx->incoming);
+    free(ctx->encoded);
+    free(ctx->gather_headers);
+    free(ctx->requests);
+    free(ctx->recv_counts);
+    free(ctx->displacements);
+    free(ctx->summaries);
+    free(ctx);
+}
+
+MPI_Comm psort_comm(const PSortContext *ctx) { return ctx->comm; }
+
+const PSortTuning *psort_tuning(const PSortContext *ctx) { return &ctx->tuning; }
+
+// --- Implementación de Quick Sort Paralelo Mejorado ---
+int psort_sort(PSortContext *ctx, int **local_array_ptr, int *local_n_ptr) {
+    bool in_window = false; // El arreglo local vive en la ventana de un nivel (no se puede usar free/realloc)
+
+    for (int l = 0; l < ctx->num_levels - 1; l++) {
+        exchange_level(ctx, &ctx->levels[l], local_array_ptr, local_n_ptr, &in_window);
+    }
+
+    // Caso base: un solo proceso en el comunicador, se ordena localmente
+    int local_n = *local_n_ptr;
+    int *local_array = *local_array_ptr;
+    if (local_n > 0) sort_local(ctx, local_array, local_n);
+
+    // El resultado final siempre se devuelve en memoria propia (malloc) para que el llamador pueda liberarlo.
+    // La ventana sigue siendo del contexto y se reutiliza en el próximo ordenamiento.
+    int status = PSORT_OK;
+    if (in_window) {
+        int *own_array = (int *)malloc((local_n > 0 ? local_n : 1) * sizeof(int));
+        if (own_array) {
+            memcpy(own_array, local_array, local_n * sizeof(int));
+        } else {
+            status = PSORT_ERR_NOMEM;
+            local_n = 0; // Nunca se devuelve un puntero dentro de la ventana
+        }
+        *local_array_ptr = own_array;
+        *local_n_ptr = local_n;
+    }
+    return agree_status(ctx, status);
+}
+
+// Sin código de retorno: como los programas de ejemplo, cualquier error se informa y aborta.
+void parallel_quicksort(int **local_array, int *local_n, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    PSortContext *ctx = psort_create(comm);
+    if (!ctx) {
+        if (rank == 0) fprintf(stderr, "parallel_quicksort: no se pudo crear el contexto (%d procesos, debe ser potencia de 2).\n", size);
+        MPI_Abort(comm, 1);
+    }
+    int status = psort_sort(ctx, local_array, local_n);
+    if (status != PSORT_OK) {
+        if (rank == 0) fprintf(stderr, "parallel_quicksort: error %d al ordenar.\n", status);
+        MPI_Abort(comm, 1);
+    }
+    psort_destroy(ctx);
+}
+
+// Un nivel del hipercubo: pivote, partición e intercambio con el socio.
+static void exchange_level(PSortContext *ctx, PSortLevel *lv, int **local_array_ptr, int *local_n_ptr, bool *in_window) {
+    int local_n = *local_n_ptr;
+    int *local_array = *local_array_ptr;
+
+    // ================== MEJORA 1: PIVOTE POR MEDIANA DE MEDIANOS ==================
+    int pivot = 0;
+    // 1. Cada proceso ordena su tramo y toma 'pivot_samples' cuantiles equiespaciados
+    //    (con una sola muestra es la mediana local)
+    if (local_n > 0) sort_local(ctx, local_array, local_n);
+    int samples = ctx->tuning.pivot_samples;
+    int sample_pairs[2 * PSORT_MAX_PIVOT_SAMPLES];
+    for (int i = 0; i < samples; i++) {
+        sample_pairs[2 * i] = (local_n > 0) ? local_array[(2LL * i + 1) * local_n / (2 * samples)] : 0;
+        sample_pairs[2 * i + 1] = 1;
+    }
+
+    // 2-4. El líder recolecta las muestras, elige la mediana de todas y la difunde
+    pivot = median_of_medians(ctx, lv->comm, sample_pairs, samples);
+    // =============================================================================
+
+    // ================== MEJORA 2: PARTICIÓN IN-PLACE ==================
+    // No se crean nuevos arreglos 'less' y 'greater', ahorrando memoria.
+    int split_point = partition_inplace(local_array, local_n, pivot);
+    int less_count = split_point;
+    int greater_count = local_n - split_point;
+    // =================================================================
+
+    // ================== MEJORA 3: INTERCAMBIO CON MPI_Sendrecv ==================
+    // Esto previene deadlocks con mensajes grandes.
+    // Grupo bajo: envía 'greater', recibe 'less' | bajo quiere deshacerse de sus números > pivot y recibir los números ≤ pivot del grupo alto.
+    // Grupo alto: envía 'less', recibe 'greater' | alto quiere deshacerse de sus números ≤ pivot y recibir los números > pivot del grupo bajo.
+    int *keep_part = (lv->color == 0) ? local_array : local_array + less_count;
+    int keep_count = (lv->color == 0) ? less_count : greater_count;
+    int *send_part = (lv->color == 0) ? local_array + less_count : local_array;
+    int send_count = (lv->color == 0) ? greater_count : less_count;
+
+    // Hacia otro nodo, el tramo saliente (ya ordenado por el qsort de la mediana) se codifica si conviene
+    int send_bytes = (lv->partner_node_rank == MPI_UNDEFINED) ? encode_if_worthwhile(ctx, send_part, send_count) : 0;
+
+    // Primero, averigua cuántos datos vas a recibir (y si vienen codificados: bytes > 0)
+    int header[2] = { send_count, send_bytes };
+    int incoming_header[2] = { 0, 0 };
+    MPI_Sendrecv(header, 2, MPI_INT, lv->partner, 0,
+                 incoming_header, 2, MPI_INT, lv->partner, 0, lv->comm, MPI_STATUS_IGNORE);
+    int incoming_count = incoming_header[0];
+    int incoming_bytes = incoming_header[1];
+    int new_n = keep_count + incoming_count;
+
+    int *new_local_array = NULL;
+    bool new_in_window = false;
+
+    // Socios en otros nodos: se mantiene el intercambio por mensajes.
+    if (lv->partner_node_rank == MPI_UNDEFINED) {
+        size_t incoming_size = (incoming_bytes > 0) ? (size_t)incoming_bytes : (size_t)incoming_count * sizeof(int);
+        void *incoming_buffer = reserve_buffer(&ctx->incoming, &ctx->incoming_capacity, incoming_size);
+
+        // Ahora, intercambia los datos
+        MPI_Sendrecv(send_bytes > 0 ? (void *)ctx->encoded : (void *)send_part,
+                     send_bytes > 0 ? send_bytes : send_count, send_bytes > 0 ? MPI_BYTE : MPI_INT, lv->partner, 1,
+                     incoming_buffer, incoming_bytes > 0 ? incoming_bytes : incoming_count,
+                     incoming_bytes > 0 ? MPI_BYTE : MPI_INT, lv->partner, 1, lv->comm, MPI_STATUS_IGNORE);
+
+        if (lv->color == 0 && !*in_window) {
+            // Combina tus datos 'less' con los recibidos; realloc conserva el prefijo 'less' sin copiarlo
+            new_local_array = (int *)realloc(local_array, new_n * sizeof(int));
+            local_array = NULL; // Ya liberado o reutilizado por realloc
+        } else {
+            // Combina tus datos 'greater' (o los de una ventana compartida) con los recibidos
+            new_local_array = (int *)malloc(new_n * sizeof(int));
+            memcpy(new_local_array, keep_part, keep_count * sizeof(int));
+        }
+        if (incoming_bytes > 0) {
+            decode_sorted_run((const unsigned char *)incoming_buffer, incoming_count, new_local_array + keep_count);
+        } else {
+            memcpy(new_local_array + keep_count, incoming_buffer, incoming_count * sizeof(int));
+        }
+    }
+
+    // ================== MEJORA 4: INTERCAMBIO POR MEMORIA COMPARTIDA ==================
+    // Si el socio está en el mismo nodo, el nuevo arreglo de cada proceso vive en la ventana
+    // compartida del nivel y el socio escribe su mitad directamente en ella: una sola copia,
+    // sin 'incoming_buffer' ni copias intermedias de MPI_Sendrecv.
+    // La ventana es del contexto: se crea una vez (colectivo sobre el nodo, los procesos que
+    // intercambian por mensajes aportan un segmento vacío) y solo se recrea si hace falta más
+    // capacidad, así que los grupos de niveles distintos no se vuelven a sincronizar al liberarla.
+    if (lv->any_local_partner) {
+        bool local_partner = (lv->partner_node_rank != MPI_UNDEFINED);
+        int *segment = reserve_level_window(lv, local_partner ? new_n : 0);
+
+        MPI_Win_fence(0, lv->win);
+        if (local_partner) {
+            // Mi segmento queda [lo que envía el socio | mis datos conservados]: él escribe al principio del mío
+            memcpy(segment + incoming_count, keep_part, keep_count * sizeof(int));
+            if (send_count > 0) memcpy(lv->partner_segment, send_part, send_count * sizeof(int));
+            new_local_array = segment;
+            new_in_window = true;
+        }
+        MPI_Win_fence(0, lv->win);
+    }
+
+    // Los datos del nivel anterior ya fueron copiados: se libera el arreglo si no vive en una ventana
+    // (la ventana del nivel anterior se reutiliza en el próximo ordenamiento).
+    if (!*in_window) free(local_array);
+    *local_array_ptr = new_local_array;
+    *local_n_ptr = new_n;
+    *in_window = new_in_window;
+    // =============================================================================
+}
+
+// --- Planificación Adaptativa ---
+// Una sonda distribuida barata (O(N/p) y dos colectivas chicas) mide el tamaño, el grado de orden
+// y el rango, y elige la estrategia más barata para esos datos.
+
+int psort_plan(PSortContext *ctx, const int *local_array, int local_n, PSortPlan *plan) {
+    int sorted_slices = plan->sorted_slices; // Dato del llamador sobre el reparto, no de la sonda
+    memset(plan, 0, sizeof(PSortPlan));
+    plan->sorted_slices = sorted_slices;
+
+    // 1. Resumen local: descensos (pares adyacentes desordenados), extremos, mínimo y máximo
+    int summary[PLAN_SUMMARY_FIELDS] = { local_n > 0, 0, 0, INT_MAX, INT_MIN, 0 };
+    if (local_n > 0) {
+        summary[1] = local_array[0];
+        summary[2] = local_array[local_n - 1];
+    }
+    for (int i = 0; i < local_n; i++) {
+        if (local_array[i] < summary[3]) summary[3] = local_array[i];
+        if (local_array[i] > summary[4]) summary[4] = local_array[i];
+        if (i > 0 && local_array[i - 1] > local_array[i]) summary[5]++;
+    }
+
+    // 2. Todos reciben todos los resúmenes y toman la misma decisión sin otra difusión
+    int *summaries = ctx->summaries;
+    MPI_Allgather(summary, PLAN_SUMMARY_FIELDS, MPI_INT, summaries, PLAN_SUMMARY_FIELDS, MPI_INT, ctx->comm);
+
+    plan->min_value = INT_MAX;
+    plan->max_value = INT_MIN;
+    plan->boundaries_ordered = 1;
+    plan->ranges_disjoint = 1;
+    int previous = -1; // Último proceso con datos
+    for (int r = 0; r < ctx->size; r++) {
+        const int *s = summaries + r * PLAN_SUMMARY_FIELDS;
+        if (!s[0]) continue;
+        plan->descents += s[5];
+        if (s[3] < plan->min_value) plan->min_value = s[3];
+        if (s[4] > plan->max_value) plan->max_value = s[4];
+        if (previous >= 0) {
+            const int *p = summaries + previous * PLAN_SUMMARY_FIELDS;
+            if (p[2] > s[1]) plan->boundaries_ordered = 0;
+            if (p[4] > s[3]) plan->ranges_disjoint = 0;
+        }
+        previous = r;
+    }
+    long long local_count = local_n;
+    MPI_Allreduce(&local_count, &plan->N, 1, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+
+    // 3. Decisión (el orden importa: primero lo que no necesita mover datos)
+    long long range = (plan->N > 0) ? (long long)plan->max_value - plan->min_value + 1 : 0;
+    if (plan->descents == 0 && plan->boundaries_ordered) {
+        plan->strategy = PSORT_STRATEGY_PRESORTED;
+    } else if (plan->ranges_disjoint) {
+        plan->strategy = PSORT_STRATEGY_LOCAL_ONLY;
+    } else if (plan->N <= ctx->tuning.gather_max_n || ctx->size < 2) {
+        plan->strategy = PSORT_STRATEGY_GATHER;
+    } else if (range <= PLAN_COUNTING_MAX_RANGE && range <= plan->N) {
+        plan->strategy = PSORT_STRATEGY_COUNTING;
+    } else {
+        plan->strategy = PSORT_STRATEGY_HYPERCUBE;
+    }
+    return PSORT_OK;
+}
+
+int psort_sort_planned(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n) {
+    switch (plan->strategy) {
+        case PSORT_STRATEGY_PRESORTED:
+            return PSORT_OK;
+        case PSORT_STRATEGY_LOCAL_ONLY:
+            if (*local_n > 0) sort_local(ctx, *local_array, *local_n);
+            return PSORT_OK;
+        case PSORT_STRATEGY_GATHER:
+            return sort_on_root(ctx, plan, local_array, local_n);
+        case PSORT_STRATEGY_COUNTING:
+            return counting_sort(ctx, plan, local_array, local_n);
+        default:
+            return psort_sort(ctx, local_array, local_n);
+    }
+}
+
+int psort_sort_auto(PSortContext *ctx, int **local_array, int *local_n, PSortPlan *plan) {
+    int status = psort_plan(ctx, *local_array, *local_n, plan);
+    if (status != PSORT_OK) return status;
+    return psort_sort_planned(ctx, plan, local_array, local_n);
+}
+
+const char *psort_strategy_name(PSortStrategy strategy) {
+    switch (strategy) {
+        case PSORT_STRATEGY_PRESORTED:  return "ya ordenado (sin trabajo)";
+        case PSORT_STRATEGY_LOCAL_ONLY: return "solo ordenamiento local (rangos disjuntos)";
+        case PSORT_STRATEGY_GATHER:     return "juntar y ordenar en el raíz";
+        case PSORT_STRATEGY_COUNTING:   return "conteo distribuido (rango chico)";
+        default:                        return "quicksort en hipercubo";
+    }
+}
+
+void psort_plan_log(const PSortPlan *plan, FILE *out) {
+    fprintf(out, "Plan: %s\n", psort_strategy_name(plan->strategy));
+    fprintf(out, "  N=%lld, descensos locales=%lld, fronteras ordenadas=%s, rangos disjuntos=%s",
+            plan->N, plan->descents, plan->boundaries_ordered ? "sí" : "no", plan->ranges_disjoint ? "sí" : "no");
+    if (plan->N > 0) fprintf(out, ", rango=[%d, %d]", plan->min_value, plan->max_value); // Sin datos no hay rango
+    fprintf(out, "\n");
+    if (plan->sorted_slices) {
+        fprintf(out, "  (tramos ordenados por el reparto: el grado de orden solo se mide en las fronteras entre procesos)\n");
+    }
+}
+
+// Estrategia para N chico: las colectivas del hipercubo cuestan más que ordenar todo en un proceso.
+// El raíz se queda con los N elementos ordenados y los demás quedan vacíos (sigue siendo un reparto válido).
+static int sort_on_root(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n) {
+    int *all = NULL;
+    int status = PSORT_OK;
+    if (ctx->rank == 0) {
+        all = (int *)malloc((plan->N > 0 ? plan->N : 1) * sizeof(int));
+        if (!all) status = PSORT_ERR_NOMEM;
+    }
+    // Sin memoria en el raíz nadie entra al gather: todos devuelven el error con sus datos intactos
+    status = agree_status(ctx, status);
+    if (status != PSORT_OK) return status;
+
+    status = psort_gather(ctx, *local_array, *local_n, all);
+    if (status != PSORT_OK) { // El error ya es el mismo en todos: los datos de cada proceso siguen intactos
+        free(all);
+        return status;
+    }
+    free(*local_array);
+
+    if (ctx->rank == 0) {
+        sort_local(ctx, all, (int)plan->N);
+        *local_array = all;
+        *local_n = (int)plan->N;
+    } else {
+        *local_array = NULL;
+        *local_n = 0;
+    }
+    return PSORT_OK;
+}
+
+// Estrategia para rangos chicos ("radix-friendly"): un solo MPI_Allreduce de un histograma de tamaño 'rango'.
+// Con el histograma global cada proceso genera directamente su bloque de la salida ordenada, sin mover datos.
+static int counting_sort(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n) {
+    int range = (int)((long long)plan->max_value - plan->min_value + 1);
+    long long start = plan->N * ctx->rank / ctx->size;
+    long long end = plan->N * (ctx->rank + 1) / ctx->size;
+
+    // Todas las reservas antes de la colectiva, para que un fallo en un proceso no deje a los demás esperando
+    int *histogram = (int *)calloc(range, sizeof(int));
+    int *output = (int *)malloc((end - start > 0 ? end - start : 1) * sizeof(int));
+    int status = agree_status(ctx, (histogram && output) ? PSORT_OK : PSORT_ERR_NOMEM);
+    if (status != PSORT_OK) {
+        free(histogram);
+        free(output);
+        return status;
+    }
+
+    for (int i = 0; i < *local_n; i++) histogram[(*local_array)[i] - plan->min_value]++;
+    MPI_Allreduce(MPI_IN_PLACE, histogram, range, MPI_INT, MPI_SUM, ctx->comm);
+
+    // Bloques balanceados: el proceso r genera las posiciones globales [start, end) = [N*r/p, N*(r+1)/p)
+    long long position = 0; // Posición global del primer elemento del valor actual
+    int written = 0;
+    for (int v = 0; v < range && position < end; v++) {
+        long long from = (position > start) ? position : start;
+        long long to = (position + histogram[v] < end) ? position + histogram[v] : end;
+        for (long long i = from; i < to; i++) output[written++] = plan->min_value + v;
+        position += histogram[v];
+    }
+
+    free(histogram);
+    free(*local_array);
+    *local_array = output;
+    *local_n = written;
+    return PSORT_OK;
+}
+
+// --- Selección Distribuida ---
+// Quickselect paralelo con el mismo pivote (mediana de medianas) y la misma partición in-place que el
+// ordenamiento, pero en cada paso solo se baja al lado que contiene los rangos buscados: O(N/p) esperado.
+
+int psort_select(PSortContext *ctx, int *local_array, int local_n, const long long *ranks, int count, int *values) {
+    long long local_count = local_n, N = 0;
+    MPI_Allreduce(&local_count, &N, 1, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+
+    SelectTarget *targets = (SelectTarget *)malloc(count * sizeof(SelectTarget));
+    if (!targets && count > 0) return PSORT_ERR_NOMEM;
+    for (int i = 0; i < count; i++) {
+        if (ranks[i] < 0 || ranks[i] >= N) {
+            free(targets);
+            return PSORT_ERR_RANGE;
+        }
+        targets[i].rank = ranks[i];
+        targets[i].index = i;
+    }
+    qsort(targets, count, sizeof(SelectTarget), compare_targets);
+
+    select_range(ctx, local_array, 0, local_n, 0, targets, count, values);
+    free(targets);
+    return PSORT_OK;
+}
+
+int psort_quantiles(PSortContext *ctx, int *local_array, int local_n, const double *quantiles, int count, int *values) {
+    long long local_count = local_n, N = 0;
+    MPI_Allreduce(&local_count, &N, 1, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+    if (N == 0) return PSORT_ERR_RANGE;
+
+    long long *ranks = (long long *)malloc(count * sizeof(long long));
+    if (!ranks && count > 0) return PSORT_ERR_NOMEM;
+    for (int i = 0; i < count; i++) {
+        if (quantiles[i] < 0.0 || quantiles[i] > 1.0) {
+            free(ranks);
+            return PSORT_ERR_RANGE;
+        }
+        ranks[i] = (long long)(quantiles[i] * (double)(N - 1));
+    }
+
+    int status = psort_select(ctx, local_array, local_n, ranks, count, values);
+    free(ranks);
+    return status;
+}
+
+int psort_top_k(PSortContext *ctx, int *local_array, int local_n, int k, int *top) {
+    long long local_count = local_n, N = 0;
+    MPI_Allreduce(&local_count, &N, 1, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+    if (k <= 0 || k > N) return PSORT_ERR_RANGE;
+
+    // El umbral es el (N - k)-ésimo menor: todo lo mayor entra seguro, el resto se completa con copias del umbral
+    long long threshold_rank = N - k;
+    int threshold;
+    int status = psort_select(ctx, local_array, local_n, &threshold_rank, 1, &threshold);
+    if (status != PSORT_OK) return status;
+
+    int greater_count = local_n - partition_inplace(local_array, local_n, threshold);
+    MPI_Gather(&greater_count, 1, MPI_INT, ctx->recv_counts, 1, MPI_INT, 0, ctx->comm);
+
+    int total_greater = 0;
+    if (ctx->rank == 0) {
+        for (int i = 0; i < ctx->size; i++) {
+            ctx->displacements[i] = total_greater;
+            total_greater += ctx->recv_counts[i];
+        }
+    }
+    MPI_Gatherv(local_array + local_n - greater_count, greater_count, MPI_INT,
+                top, ctx->recv_counts, ctx->displacements, MPI_INT, 0, ctx->comm);
+
+    if (ctx->rank == 0) {
+        for (int i = total_greater; i < k; i++) top[i] = threshold;
+        qsort(top, k, sizeof(int), compare_integers);
+        for (int i = 0, j = k - 1; i < j; i++, j--) {
+            int temp = top[i];
+            top[i] = top[j];
+            top[j] = temp;
+        }
+    }
+    return PSORT_OK;
+}
+
+// Selección recursiva sobre el rango local [lo, hi). Entre todos los procesos, los candidatos ocupan los
+// rangos globales [base, base + total). 'targets' está ordenado por rango y todos sus rangos caen en ese intervalo.
+// Todos los procesos toman las mismas decisiones porque dependen solo de conteos globales.
+static void select_range(PSortContext *ctx, int *array, int lo, int hi, long long base, SelectTarget *targets, int count, int *values) {
+    if (count == 0) return;
+
+    int local_count = hi - lo;
+    long long local_count_ll = local_count, total = 0;
+    MPI_Allreduce(&local_count_ll, &total, 1, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+
+    // Pocos candidatos: se juntan en todos los procesos y se resuelven todos los objetivos restantes de una vez
+    if (total <= SELECT_GATHER_THRESHOLD) {
+        MPI_Allgather(&local_count, 1, MPI_INT, ctx->recv_counts, 1, MPI_INT, ctx->comm);
+        ctx->displacements[0] = 0;
+        for (int i = 1; i < ctx->size; i++) {
+            ctx->displacements[i] = ctx->displacements[i - 1] + ctx->recv_counts[i - 1];
+        }
+        int *candidates = (int *)malloc(total * sizeof(int));
+        MPI_Allgatherv(array + lo, local_count, MPI_INT, candidates, ctx->recv_counts, ctx->displacements, MPI_INT, ctx->comm);
+        qsort(candidates, total, sizeof(int), compare_integers);
+        for (int t = 0; t < count; t++) values[targets[t].index] = candidates[targets[t].rank - base];
+        free(candidates);
+        return;
+    }
+
+    // Pivote: mediana de medianas ponderada por la cantidad de candidatos de cada proceso.
+    // Las medianas locales se obtienen con quickselect (O(n)) en lugar de ordenar.
+    int median_pair[2] = { 0, local_count };
+    if (local_count > 0) median_pair[0] = local_select(array + lo, local_count, local_count / 2);
+    int pivot = median_of_medians(ctx, ctx->comm, median_pair, 1);
+
+    int less_count, less_equal_count;
+    partition3(array + lo, local_count, pivot, &less_count, &less_equal_count);
+    long long local_counts[2] = { less_count, less_equal_count }, global_counts[2];
+    MPI_Allreduce(local_counts, global_counts, 2, MPI_LONG_LONG, MPI_SUM, ctx->comm);
+
+    // Objetivos a la izquierda del pivote, iguales al pivote (resueltos) y a la derecha
+    int left = 0;
+    while (left < count && targets[left].rank < base + global_counts[0]) left++;
+    int right = left;
+    while (right < count && targets[right].rank < base + global_counts[1]) {
+        values[targets[right].index] = pivot;
+        right++;
+    }
+
+    select_range(ctx, array, lo, lo + less_count, base, targets, left, values);
+    select_range(ctx, array, lo + less_equal_count, hi, base + global_counts[1], targets + right, count - right, values);
+}
+
+// --- Entrada / Salida ---
+
+int psort_read_file(const char *path, int **global_array, int *N) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("Error abriendo el archivo");
+        return PSORT_ERR_IO;
+    }
+
+    // Leer N y los datos desde el archivo
+    if (fscanf(file, "%d", N) != 1 || *N < 0) {
+        fprintf(stderr, "Error: no se pudo leer N desde %s.\n", path);
+        fclose(file);
+        return PSORT_ERR_IO;
+    }
+
+    *global_array = (int *)malloc(*N * sizeof(int));
+    if (!*global_array && *N > 0) {
+        perror("Error de asignación de memoria");
+        fclose(file);
+        return PSORT_ERR_NOMEM;
+    }
+    for (int i = 0; i < *N; i++) {
+        if (fscanf(file, "%d", &(*global_array)[i]) != 1) {
+            fprintf(stderr, "Error: %s contiene menos de %d números.\n", path, *N);
+            free(*global_array);
+            *global_array = NULL;
+            fclose(file);
+            return PSORT_ERR_IO;
+        }
+    }
+    fclose(file);
+    return PSORT_OK;
+}
+
+int psort_scatter(PSortContext *ctx, const int *global_array, int *N, int **local_array, int *local_n) {
+    // El raíz difunde N junto con el resultado de la validación para que todos devuelvan lo mismo
+    int header[2] = { *N, PSORT_OK };
+    if (ctx->rank == 0 && *N % ctx->size != 0) header[1] = PSORT_ERR_SIZE;
+    MPI_Bcast(header, 2, MPI_INT, 0, ctx->comm);
+    *N = header[0];
+    if (header[1] != PSORT_OK) return header[1];
+
+    *local_n = *N / ctx->size;
+    *local_array = (int *)malloc(*local_n * sizeof(int));
+
+    MPI_Scatter(global_array, *local_n, MPI_INT, *local_array, *local_n, MPI_INT, 0, ctx->comm);
+    return PSORT_OK;
+}
+
+int psort_gather(PSortContext *ctx, const int *local_array, int local_n, int *global_array) {
+#if USE_COMPRESSION
+    // Si algún proceso logra comprimir su tramo, el raíz recibe proceso por proceso y decodifica.
+    // El raíz no codifica: su tramo se copia directamente.
+    int local_bytes = (ctx->rank == 0) ? 0 : encode_if_worthwhile(ctx, local_array, local_n);
+    int max_bytes = 0;
+    MPI_Allreduce(&local_bytes, &max_bytes, 1, MPI_INT, MPI_MAX, ctx->comm);
+    if (max_bytes > 0) return gather_encoded(ctx, local_array, local_n, local_bytes, max_bytes, global_array);
+#endif
+
+    MPI_Gather(&local_n, 1, MPI_INT, ctx->recv_counts, 1, MPI_INT, 0, ctx->comm);
+
+    if (ctx->rank == 0) {
+        ctx->displacements[0] = 0;
+        for (int i = 1; i < ctx->size; i++) {
+            ctx->displacements[i] = ctx->displacements[i - 1] + ctx->recv_counts[i - 1];
+        }
+    }
+
+    MPI_Gatherv(local_array, local_n, MPI_INT, global_array, ctx->recv_counts, ctx->displacements, MPI_INT, 0, ctx->comm);
+    return PSORT_OK;
+}
+
+#if USE_COMPRESSION
+// Variante de psort_gather con tramos codificados. El raíz no reserva otro arreglo del tamaño de N:
+// los tramos crudos se reciben directamente en su lugar de 'global_array' y los codificados se reciben
+// de a uno en un buffer del tamaño del mayor ('max_bytes') y se decodifican en su lugar.
+static int gather_encoded(PSortContext *ctx, const int *local_array, int local_n, int local_bytes, int max_bytes, int *global_array) {
+    int header[2] = { local_n, local_bytes };
+    MPI_Gather(header, 2, MPI_INT, ctx->gather_headers, 2, MPI_INT, 0, ctx->comm);
+
+    int status = PSORT_OK;
+    unsigned char *scratch = NULL;
+    if (ctx->rank == 0) {
+        scratch = (unsigned char *)reserve_buffer(&ctx->incoming, &ctx->incoming_capacity, (size_t)max_bytes);
+        if (!scratch) status = PSORT_ERR_NOMEM;
+    }
+    status = agree_status(ctx, status); // Nadie envía si el raíz no puede recibir
+    if (status != PSORT_OK) return status;
+
+    if (ctx->rank != 0) {
+        if (local_bytes > 0) {
+            MPI_Send(ctx->encoded, local_bytes, MPI_BYTE, 0, GATHER_TAG, ctx->comm);
+        } else if (local_n > 0) {
+            MPI_Send(local_array, local_n, MPI_INT, 0, GATHER_TAG, ctx->comm);
+        }
+        return PSORT_OK;
+    }
+
+    // Raíz: primero se publican las recepciones crudas para que avancen mientras se decodifica el resto
+    memcpy(global_array, local_array, local_n * sizeof(int));
+    int pending = 0;
+    size_t position = local_n;
+    for (int i = 1; i < ctx->size; i++) {
+        int count = ctx->gather_headers[2 * i], bytes = ctx->gather_headers[2 * i + 1];
+        if (bytes == 0 && count > 0) {
+            MPI_Irecv(global_array + position, count, MPI_INT, i, GATHER_TAG, ctx->comm, &ctx->requests[pending++]);
+        }
+        position += count;
+    }
+
+    position = local_n;
+    for (int i = 1; i < ctx->size; i++) {
+        int count = ctx->gather_headers[2 * i], bytes = ctx->gather_headers[2 * i + 1];
+        if (bytes > 0) {
+            MPI_Recv(scratch, bytes, MPI_BYTE, i, GATHER_TAG, ctx->comm, MPI_STATUS_IGNORE);
+            decode_sorted_run(scratch, count, global_array + position);
+        }
+        position += count;
+    }
+
+    MPI_Waitall(pending, ctx->requests, MPI_STATUSES_IGNORE);
+    return PSORT_OK;
+}
+#endif
+
+// --- Compresión de Tramos Ordenados ---
+// Formato: el primer valor en zigzag y luego las diferencias con el anterior (no negativas en un tramo
+// ordenado), todo como varint de 7 bits por byte. Con datos densos cada entero ocupa 1 o 2 bytes en lugar de 4.
+
+// Codifica 'values' en ctx->encoded si tiene al menos 'compress_min_count' enteros y la compresión
+// estimada alcanza COMPRESS_MIN_RATIO.
+// Devuelve los bytes codificados, o 0 si conviene enviar los enteros crudos.
+static int encode_if_worthwhile(PSortContext *ctx, const int *values, int count) {
+#if USE_COMPRESSION
+    if (count < 2 || count < ctx->tuning.compress_min_count || values[0] > values[count - 1]) return 0;
+
+    // Estimación barata con la diferencia promedio (sin recorrer el tramo)
+    double average_delta = ((double)values[count - 1] - values[0]) / (count - 1);
+    int estimated_bytes = (average_delta < (1 << 7)) ? 1 : (average_delta < (1 << 14)) ? 2 : (average_delta < (1 << 21)) ? 3 : 4;
+    if ((double)sizeof(int) / estimated_bytes < COMPRESS_MIN_RATIO) return 0;
+
+    // La capacidad limita el resultado: si la codificación real no alcanza la relación mínima, se descarta.
+    // Los bytes viajan como conteo int de MPI_BYTE: un tramo cuyo límite no entra en un int va crudo.
+    size_t capacity = (size_t)((double)count * sizeof(int) / COMPRESS_MIN_RATIO);
+    if (capacity > INT_MAX) return 0;
+    if (!reserve_buffer((void **)&ctx->encoded, &ctx->encoded_capacity, capacity)) return 0;
+    int bytes = encode_sorted_run(values, count, ctx->encoded, (int)capacity);
+    return (bytes > 0) ? bytes : 0;
+#else
+    (void)ctx; (void)values; (void)count;
+    return 0;
+#endif
+}
+
+#if USE_COMPRESSION
+// Devuelve los bytes escritos, o -1 si el tramo no está ordenado o no entra en 'capacity'
+static int encode_sorted_run(const int *values, int count, unsigned char *out, int capacity) {
+    int position = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned int v;
+        if (i == 0) {
+            v = ((unsigned int)values[0] << 1) ^ (unsigned int)(values[0] >> 31); // zigzag
+        } else {
+            if (values[i] < values[i - 1]) return -1;
+            v = (unsigned int)values[i] - (unsigned int)values[i - 1];
+        }
+        int length = 1 + (v >= 0x80) + (v >= 0x4000) + (v >= 0x200000) + (v >= 0x10000000);
+        if (position + length > capacity) return -1;
+        while (v >= 0x80) {
+            out[position++] = (unsigned char)(v | 0x80);
+            v >>= 7;
+        }
+        out[position++] = (unsigned char)v;
+    }
+    return position;
+}
+#endif
+
+static void decode_sorted_run(const unsigned char *in, int count, int *out) {
+    unsigned int previous = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned int v = *in++;
+        if (v >= 0x80) { // Camino lento: varint de más de un byte
+            v &= 0x7F;
+            int shift = 7;
+            unsigned int b;
+            do {
+                b = *in++;
+                v |= (b & 0x7F) << shift;
+                shift += 7;
+            } while (b >= 0x80);
+        }
+        if (i == 0) {
+            previous = (v >> 1) ^ (0u - (v & 1)); // zigzag inverso
+        } else {
+            previous += v;
+        }
+        out[i] = (int)previous;
+    }
+}
+
+// --- Distribución en Streaming ---
+// El raíz nunca tiene el arreglo completo: lee el archivo por bloques de 'stream_block_size' enteros y envía
+// cada bloque terminado a su destino con MPI_Isend mientras lee el siguiente. Cada proceso recibe el mismo
+// tramo contiguo que con un reparto equilibrado, ordena cada bloque al llegar y al final mezcla los bloques.
+
+int psort_stream_file(PSortContext *ctx, const char *path, int *N, int **local_array, int *local_n) {
+    TextReader reader;
+    reader.file = NULL;
+    reader.position = reader.length = 0;
+    int header[2] = { 0, PSORT_OK };
+
+    if (ctx->rank == 0) {
+        reader.file = fopen(path, "r");
+        if (!reader.file) {
+            perror("Error abriendo el archivo");
+            header[1] = PSORT_ERR_IO;
+        } else if (!read_next_int(&reader, &header[0]) || header[0] < 0) {
+            fprintf(stderr, "Error: no se pudo leer N desde %s.\n", path);
+            header[1] = PSORT_ERR_IO;
+        }
+    }
+    MPI_Bcast(header, 2, MPI_INT, 0, ctx->comm);
+    *N = header[0];
+    if (header[1] != PSORT_OK) {
+        if (reader.file) fclose(reader.file);
+        return header[1];
+    }
+
+    // Tramo equilibrado de cada proceso: posiciones globales [N*r/p, N*(r+1)/p)
+    int start = (int)((long long)*N * ctx->rank / ctx->size);
+    int end = (int)((long long)*N * (ctx->rank + 1) / ctx->size);
+    int block = ctx->tuning.stream_block_size;
+    *local_n = end - start;
+
+    // Todas las reservas antes de empezar a enviar (el tramo, el buffer de la mezcla final y, en el raíz,
+    // el doble buffer), para que un fallo en cualquier proceso se acuerde sin dejar a nadie esperando
+    int *blocks[2] = { NULL, NULL };
+    int *merge_buffer = NULL;
+    *local_array = (int *)malloc((*local_n > 0 ? *local_n : 1) * sizeof(int));
+    bool allocated = (*local_array != NULL);
+    if (*local_n > block) {
+        merge_buffer = (int *)malloc(*local_n * sizeof(int));
+        allocated = allocated && merge_buffer;
+    }
+    if (ctx->rank == 0 && ctx->size > 1) {
+        blocks[0] = (int *)malloc((size_t)block * sizeof(int));
+        blocks[1] = (int *)malloc((size_t)block * sizeof(int));
+        allocated = allocated && blocks[0] && blocks[1];
+    }
+
+    int status = agree_status(ctx, allocated ? PSORT_OK : PSORT_ERR_NOMEM);
+    if (status == PSORT_OK) {
+        if (ctx->rank == 0) {
+            status = stream_blocks_from_root(ctx, &reader, *N, *local_array, *local_n, blocks);
+            if (status == PSORT_ERR_IO) fprintf(stderr, "Error: %s contiene menos de %d números.\n", path, *N);
+        } else {
+            receive_stream_blocks(ctx, *local_array, *local_n);
+        }
+
+        // Un archivo más corto que N se detecta tarde: el raíz completa el protocolo y avisa al final
+        MPI_Bcast(&status, 1, MPI_INT, 0, ctx->comm);
+    }
+
+    if (reader.file) fclose(reader.file);
+    free(blocks[0]);
+    free(blocks[1]);
+    if (status == PSORT_OK) merge_sorted_blocks(*local_array, *local_n, block, merge_buffer);
+    free(merge_buffer);
+    if (status != PSORT_OK) {
+        free(*local_array);
+        *local_array = NULL;
+        *local_n = 0;
+    }
+    return status;
+}
+
+// Raíz: lee su propio tramo directamente en 'own_array' y los demás en dos buffers alternados,
+// de modo que siempre hay un bloque en vuelo mientras se interpreta el siguiente. Memoria: O(bloque).
+static int stream_blocks_from_root(PSortContext *ctx, TextReader *reader, int N, int *own_array, int own_n, int *blocks[2]) {
+    int status = PSORT_OK;
+    int block = ctx->tuning.stream_block_size;
+
+    // 1. Tramo propio, ordenando cada bloque al completarse
+    for (int offset = 0; offset < own_n; offset += block) {
+        int count = (own_n - offset < block) ? own_n - offset : block;
+        if (read_int_block(reader, own_array + offset, count) != count) status = PSORT_ERR_IO;
+        sort_local(ctx, own_array + offset, count);
+    }
+
+    // 2. Tramos de los demás procesos, en el orden del archivo
+    MPI_Request requests[2] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+    int current = 0;
+
+    for (int r = 1; r < ctx->size; r++) {
+        int start = (int)((long long)N * r / ctx->size);
+        int end = (int)((long long)N * (r + 1) / ctx->size);
+        for (int offset = start; offset < end; offset += block) {
+            int count = (end - offset < block) ? end - offset : block;
+
+            // El buffer se reutiliza solo cuando su envío anterior terminó
+            MPI_Wait(&requests[current], MPI_STATUS_IGNORE);
+            if (read_int_block(reader, blocks[current], count) != count) status = PSORT_ERR_IO;
+            MPI_Isend(blocks[current], count, MPI_INT, r, STREAM_TAG, ctx->comm, &requests[current]);
+            current = 1 - current;
+        }
+    }
+
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+    return status;
+}
+
+// Receptores: el siguiente bloque se recibe (MPI_Irecv directo en su lugar del arreglo local)
+// mientras se ordena el que acaba de llegar.
+static void receive_stream_blocks(PSortContext *ctx, int *local_array, int local_n) {
+    if (local_n == 0) return;
+    int block = ctx->tuning.stream_block_size;
+
+    MPI_Request request;
+    int count = (local_n < block) ? local_n : block;
+    MPI_Irecv(local_array, count, MPI_INT, 0, STREAM_TAG, ctx->comm, &request);
+
+    for (int offset = 0; offset < local_n; offset += block) {
+        count = (local_n - offset < block) ? local_n - offset : block;
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+        int next_offset = offset + block;
+        if (next_offset < local_n) {
+            int next_count = (local_n - next_offset < block) ? local_n - next_offset : block;
+            MPI_Irecv(local_array + next_offset, next_count, MPI_INT, 0, STREAM_TAG, ctx->comm, &request);
+        }
+        sort_local(ctx, local_array + offset, count);
+    }
+}
+
+// Mezcla de abajo hacia arriba de bloques ya ordenados de largo 'run' (el último puede ser más corto).
+// 'buffer' tiene espacio para 'n' enteros (puede ser NULL si n <= run).
+static void merge_sorted_blocks(int *array, int n, int run, int *buffer) {
+    if (n <= run) return;
+    int *from = array, *to = buffer;
+
+    for (int width = run; width < n; width *= 2) {
+        for (int left = 0; left < n; left += 2 * width) {
+            int middle = (left + width < n) ? left + width : n;
+            int right = (left + 2 * width < n) ? left + 2 * width : n;
+            int i = left, j = middle, k = left;
+            while (i < middle && j < right) to[k++] = (from[j] < from[i]) ? from[j++] : from[i++];
+            while (i < middle) to[k++] = from[i++];
+            while (j < right) to[k++] = from[j++];
+        }
+        int *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != array) memcpy(array, from, n * sizeof(int));
+}
+
+// --- Funciones Auxiliares ---
+
+// Pivote colectivo: el líder de 'comm' recolecta 'pair_count' pares (muestra, peso) de cada proceso y
+// elige la mediana ponderada de todas las muestras (con una mediana local de peso 1 por proceso es la
+// mediana de medianas clásica). Las muestras con peso 0 no votan. Devuelve el pivote en todos los procesos.
+static int median_of_medians(PSortContext *ctx, MPI_Comm comm, const int *pairs, int pair_count) {
+    int comm_rank, comm_size;
+    MPI_Comm_rank(comm, &comm_rank);
+    MPI_Comm_size(comm, &comm_size);
+
+    int pivot = 0;
+    int total_pairs = comm_size * pair_count;
+    MPI_Gather(pairs, 2 * pair_count, MPI_INT, ctx->medians, 2 * pair_count, MPI_INT, 0, comm);
+
+    if (comm_rank == 0) {
+        qsort(ctx->medians, total_pairs, 2 * sizeof(int), compare_median_pairs);
+        long long total_weight = 0;
+        for (int i = 0; i < total_pairs; i++) total_weight += ctx->medians[2 * i + 1];
+
+        long long accumulated = 0;
+        for (int i = 0; i < total_pairs; i++) {
+            accumulated += ctx->medians[2 * i + 1];
+            if (accumulated > total_weight / 2) {
+                pivot = ctx->medians[2 * i];
+                break;
+            }
+        }
+    }
+
+    MPI_Bcast(&pivot, 1, MPI_INT, 0, comm);
+    return pivot;
+}
+
+// Ordenamiento local con el algoritmo elegido en los parámetros del contexto
+static void sort_local(const PSortContext *ctx, int *array, int n) {
+    if (ctx->tuning.local_sort == PSORT_LOCAL_INTROSORT) {
+        local_sort(array, n);
+    } else {
+        qsort(array, n, sizeof(int), compare_integers);
+    }
+}
+
+// Devuelve un buffer del contexto con espacio para 'bytes' (crece, nunca se achica)
+static void *reserve_buffer(void **buffer, size_t *capacity, size_t bytes) {
+    if (bytes > *capacity) {
+        free(*buffer);
+        *buffer = malloc(bytes);
+        *capacity = *buffer ? bytes : 0;
+    }
+    return *buffer;
+}
+
+// Ventana compartida del nivel con espacio para 'needed' enteros en mi segmento (colectiva sobre el nodo).
+// Se crea en el primer uso aunque nadie necesite espacio (las fences requieren una ventana válida) y solo
+// se recrea si algún proceso del nodo necesita más de lo que tiene; el que crece reserva un margen para
+// que los próximos ordenamientos, con tramos algo distintos, no la vuelvan a crear.
+static int *reserve_level_window(PSortLevel *lv, int needed) {
+    int grow = (lv->win == MPI_WIN_NULL || needed > lv->capacity), any_grow = 0;
+    MPI_Allreduce(&grow, &any_grow, 1, MPI_INT, MPI_LOR, lv->node_comm);
+    if (!any_grow) return lv->segment;
+
+    if (lv->win != MPI_WIN_NULL) MPI_Win_free(&lv->win);
+    if (grow) lv->capacity = (MPI_Aint)needed + needed / 4 + 1; // Al menos un entero por segmento
+    MPI_Win_allocate_shared(lv->capacity * (MPI_Aint)sizeof(int), sizeof(int), MPI_INFO_NULL, lv->node_comm, &lv->segment, &lv->win);
+
+    lv->partner_segment = NULL;
+    if (lv->partner_node_rank != MPI_UNDEFINED) {
+        MPI_Aint partner_size;
+        int partner_disp_unit;
+        MPI_Win_shared_query(lv->win, lv->partner_node_rank, &partner_size, &partner_disp_unit, &lv->partner_segment);
+    }
+    return lv->segment;
+}
+
+// Combina el código de retorno de todos los procesos (colectiva): si alguno falló, todos devuelven un error
+static int agree_status(PSortContext *ctx, int status) {
+    int agreed = PSORT_OK;
+    MPI_Allreduce(&status, &agreed, 1, MPI_INT, MPI_MAX, ctx->comm);
+    return agreed;
+}
+
+#if USE_SHARED_EXCHANGE
+// Traduce un rango de 'comm' a su rango dentro de 'node_comm' (MPI_UNDEFINED si está en otro nodo).
+static int node_rank_of(MPI_Comm comm, MPI_Comm node_comm, int rank) {
+    MPI_Group comm_group, node_group;
+    int node_rank;
+    MPI_Comm_group(comm, &comm_group);
+    MPI_Comm_group(node_comm, &node_group);
+    MPI_Group_translate_ranks(comm_group, 1, &rank, node_group, &node_rank);
+    MPI_Group_free(&comm_group);
+    MPI_Group_free(&node_group);
+    return node_rank;
+}
+#endif
+
+// Particiona un arreglo in-place y devuelve el número de elementos <= pivote
+int partition_inplace(int *array, int n, int pivot) {
+    int i = 0, j = n - 1;
+    while (i <= j) {
+        while (i < n && array[i] <= pivot) { i++; }
+        while (j >= 0 && array[j] > pivot) { j--; }
+        if (i < j) {
+            int temp = array[i];
+            array[i] = array[j];
+            array[j] = temp;
+        }
+    }
+    return i;
+}
+
+// Comparación sin la resta (a - b), que desborda con valores de signo opuesto cercanos a INT_MIN/INT_MAX
+int compare_integers(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Particiona en tres zonas: [< pivote | == pivote | > pivote], usando dos pasadas de partition_inplace
+static void partition3(int *array, int n, int pivot, int *less_count, int *less_equal_count) {
+    *less_equal_count = partition_inplace(array, n, pivot);
+    *less_count = (pivot == INT_MIN) ? 0 : partition_inplace(array, *less_equal_count, pivot - 1);
+}
+
+// Quickselect local: devuelve el k-ésimo menor (desde 0) de 'array', reordenándolo. O(n) esperado.
+static int local_select(int *array, int n, int k) {
+    while (true) {
+        int pivot = array[n / 2];
+        int less_count, less_equal_count;
+        partition3(array, n, pivot, &less_count, &less_equal_count);
+        if (k < less_count) {
+            n = less_count;
+        } else if (k < less_equal_count) {
+            return pivot;
+        } else {
+            array += less_equal_count;
+            n -= less_equal_count;
+            k -= less_equal_count;
+        }
+    }
+}
+
+static int compare_targets(const void *a, const void *b) {
+    long long ra = ((const SelectTarget *)a)->rank, rb = ((const SelectTarget *)b)->rank;
+    return (ra > rb) - (ra < rb);
+}
+
+static int compare_median_pairs(const void *a, const void *b) {
+    return compare_integers(a, b); // El par empieza con la mediana
+}
@@ -0,0 +1,173 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <mpi.h>
+#include <stdio.h>
+
+// Biblioteca de Quicksort paralelo (hipercubo) con MPI.
+// compilar junto al programa que la usa: ' mpicc mi_programa.c parallel_sort.c local_sort.c text_reader.c -o mi_programa -O3 '
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Códigos de retorno ---
+#define PSORT_OK          0
+#define PSORT_ERR_IO      1  // No se pudo abrir o leer el archivo de entrada
+#define PSORT_ERR_SIZE    2  // N no es divisible por el número de procesos
+#define PSORT_ERR_NOMEM   3  // Falló una reserva de memoria
+#define PSORT_ERR_RANGE   4  // Rango, cuantil o k fuera de los datos
+#define PSORT_ERR_CONFIG  5  // Archivo de parámetros o parámetro "clave=valor" inválido
+
+/**
+ * @brief Contexto persistente de ordenamiento ligado a un comunicador.
+ *        Guarda los sub-comunicadores de cada nivel del hipercubo (y sus comunicadores de nodo),
+ *        ya calculados, y los buffers de trabajo que se reutilizan entre llamadas.
+ *        Crearlo una vez y usarlo para muchos ordenamientos amortiza la preparación de MPI.
+ */
+typedef struct PSortContext PSortContext;
+
+/** @brief Crea un contexto sobre 'comm' (colectiva). Devuelve NULL (en todos los procesos) si el número de procesos no es potencia de 2 o si falta memoria en alguno. */
+PSortContext *psort_create(MPI_Comm comm);
+
+// --- Parámetros Ajustables ---
+// Los valores por defecto salen de las macros de parallel_sort.c; parallel_tune.h los ajusta por máquina.
+
+#define PSORT_MAX_PIVOT_SAMPLES 64
+
+/** @brief Algoritmo de los ordenamientos locales (tramo base, bloques del streaming, estrategias locales). */
+typedef enum {
+    PSORT_LOCAL_QSORT,      // qsort de la biblioteca estándar
+    PSORT_LOCAL_INTROSORT   // local_sort de local_sort.c (sin llamada a comparador por elemento)
+} PSortLocalSort;
+
+/** @brief Parámetros de un contexto. Deben ser iguales en todos los procesos. */
+typedef struct {
+    int pivot_samples;          // Muestras por proceso para el pivote de cada nivel (1 = mediana local), hasta PSORT_MAX_PIVOT_SAMPLES
+    long long gather_max_n;     // Hasta este N el planificador junta y ordena todo en un solo proceso
+    int stream_block_size;      // Enteros por bloque (y por cada buffer del doble buffer) en psort_stream_file
+    int compress_min_count;     // Tramo mínimo, en enteros, para intentar el códec en un intercambio
+    PSortLocalSort local_sort;  // Algoritmo de ordenamiento local
+    int ranks_per_node;         // 0: comparten memoria todos los procesos del nodo; k: grupos de k consecutivos (1 = solo mensajes)
+} PSortTuning;
+
+/** @brief Carga en 'tuning' los valores por defecto. */
+void psort_tuning_defaults(PSortTuning *tuning);
+
+/** @brief Como psort_create pero con parámetros propios (colectiva). 'tuning' se copia. NULL si psort_create lo sería. */
+PSortContext *psort_create_tuned(MPI_Comm comm, const PSortTuning *tuning);
+
+/** @brief Parámetros con los que se creó el contexto. */
+const PSortTuning *psort_tuning(const PSortContext *ctx);
+
+/** @brief Libera el contexto y sus sub-comunicadores (colectiva). */
+void psort_destroy(PSortContext *ctx);
+
+/**
+ * @brief Ordena los datos distribuidos entre los procesos del contexto (colectiva).
+ *        '*local_array' es un buffer del llamador reservado con malloc; la biblioteca puede
+ *        reemplazarlo (realloc/free) porque la cantidad local cambia. Al volver, cada proceso
+ *        tiene un tramo ordenado y los tramos están ordenados entre sí según el rango.
+ *        Devuelve el mismo código en todos los procesos; con un error el reparto resultante no es válido.
+ */
+int psort_sort(PSortContext *ctx, int **local_array, int *local_n);
+
+// --- Planificación Adaptativa ---
+
+/** @brief Estrategias de ordenamiento que puede elegir psort_plan. */
+typedef enum {
+    PSORT_STRATEGY_HYPERCUBE,   // Quicksort paralelo en hipercubo (psort_sort)
+    PSORT_STRATEGY_PRESORTED,   // Los datos ya están ordenados globalmente: no se hace nada
+    PSORT_STRATEGY_LOCAL_ONLY,  // Los rangos de los procesos no se solapan: basta ordenar cada tramo
+    PSORT_STRATEGY_GATHER,      // N chico: se junta todo en el raíz y se ordena ahí
+    PSORT_STRATEGY_COUNTING     // Rango de valores chico: ordenamiento por conteo con un solo Allreduce
+} PSortStrategy;
+
+/** @brief Resultado de la sonda distribuida y estrategia elegida (idéntico en todos los procesos). */
+typedef struct {
+    PSortStrategy strategy;
+    long long N;
+    long long descents;         // Pares adyacentes desordenados dentro de los tramos locales
+    int boundaries_ordered;     // El último de cada proceso es <= al primero del siguiente
+    int ranges_disjoint;        // El máximo de cada proceso es <= al mínimo del siguiente
+    int min_value, max_value;
+    int sorted_slices;          // Lo fija el llamador antes de psort_plan (se conserva): 1 si los tramos
+                                // vienen ordenados del reparto (psort_stream_file) y los descensos no informan
+} PSortPlan;
+
+/** @brief Corre la sonda (O(N/p), colectiva) y elige una estrategia. No modifica los datos. */
+int psort_plan(PSortContext *ctx, const int *local_array, int local_n, PSortPlan *plan);
+
+/**
+ * @brief Ordena con la estrategia del plan (colectiva). Mismo contrato que psort_sort; con
+ *        PSORT_STRATEGY_GATHER el raíz se queda con todos los datos y el resto queda vacío.
+ */
+int psort_sort_planned(PSortContext *ctx, const PSortPlan *plan, int **local_array, int *local_n);
+
+/** @brief psort_plan + psort_sort_planned. 'plan' recibe la decisión tomada para poder registrarla. */
+int psort_sort_auto(PSortContext *ctx, int **local_array, int *local_n, PSortPlan *plan);
+
+/** @brief Nombre legible de una estrategia. */
+const char *psort_strategy_name(PSortStrategy strategy);
+
+/** @brief Escribe el plan (estrategia y mediciones de la sonda) en 'out'. */
+void psort_plan_log(const PSortPlan *plan, FILE *out);
+
+// --- Selección Distribuida (sin ordenar todo) ---
+// Las tres funciones son colectivas, reordenan 'local_array' de cada proceso y requieren
+// O(N/p) de trabajo esperado en lugar del O(N/p log N) de psort_sort + MPI_Gatherv.
+
+/**
+ * @brief Elementos de rango global 'ranks[i]' (0 = el menor) de los datos distribuidos.
+ *        'values' recibe 'count' resultados en todos los procesos.
+ */
+int psort_select(PSortContext *ctx, int *local_array, int local_n, const long long *ranks, int count, int *values);
+
+/** @brief Cuantiles (0.0 = mínimo, 0.5 = mediana, 1.0 = máximo) con rango floor(q * (N - 1)). Resultados en todos los procesos. */
+int psort_quantiles(PSortContext *ctx, int *local_array, int local_n, const double *quantiles, int count, int *values);
+
+/** @brief Los 'k' mayores valores globales, de mayor a menor, en 'top' del raíz (espacio para k enteros). */
+int psort_top_k(PSortContext *ctx, int *local_array, int local_n, int k, int *top);
+
+/** @brief Lee un archivo con el formato "N seguido de N enteros". Solo lo llama el proceso raíz. */
+int psort_read_file(const char *path, int **global_array, int *N);
+
+/**
+ * @brief Reparte 'global_array' (válido solo en el raíz) en bloques iguales (colectiva).
+ *        '*N' se difunde desde el raíz. Devuelve el mismo código en todos los procesos.
+ */
+int psort_scatter(PSortContext *ctx, const int *global_array, int *N, int **local_array, int *local_n);
+
+/**
+ * @brief Distribución en streaming (colectiva): el raíz lee 'path' por bloques y envía cada bloque a su
+ *        destino mientras lee el siguiente, sin reservar nunca N enteros. Cada proceso recibe un tramo
+ *        contiguo equilibrado (N no necesita ser divisible por el número de procesos), ya ordenado
+ *        localmente. '*N' queda igual en todos los procesos. Devuelve el mismo código en todos; con
+ *        un error (PSORT_ERR_IO si el archivo tiene menos de N números) '*local_array' queda en NULL.
+ */
+int psort_stream_file(PSortContext *ctx, const char *path, int *N, int **local_array, int *local_n);
+
+/**
+ * @brief Recolecta los tramos ordenados en 'global_array' del raíz (colectiva).
+ *        'global_array' debe tener espacio para N enteros en el raíz; se ignora en los demás.
+ *        Con tramos comprimidos el raíz solo reserva además un buffer del tamaño del mayor tramo codificado.
+ */
+int psort_gather(PSortContext *ctx, const int *local_array, int local_n, int *global_array);
+
+/** @brief Comunicador del contexto (duplicado del que se pasó a psort_create). */
+MPI_Comm psort_comm(const PSortContext *ctx);
+
+/** @brief Versión de una sola llamada: crea un contexto temporal, ordena y lo libera. Ante un error lo informa y llama a MPI_Abort. */
+void parallel_quicksort(int **local_array, int *local_n, MPI_Comm comm);
+
+// --- Utilidades compartidas ---
+int compare_integers(const void *a, const void *b);
+
+/** @brief Particiona un arreglo in-place y devuelve el número de elementos <= pivote. */
+int partition_inplace(int *array, int n, int pivot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARALLEL_SORT_H
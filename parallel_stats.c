@@ -0,0 +1,137 @@
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include "parallel_stats.h"
+#include "primes.h"
+
+// Etapa de análisis fusionada: una pasada local por corridas de valores iguales + un MPI_Reduce.
+
+// --- Prototipos de Funciones Internas ---
+static void local_stats(const int *array, int n, int flags, int histogram_min, int histogram_max, PSortStats *stats);
+static long long histogram_range(const PSortStats *stats);
+static long long bucket_low(const PSortStats *stats, int bucket);
+static void merge_stats(const PSortStats *left, PSortStats *right);
+static void combine_stats(void *in, void *inout, int *len, MPI_Datatype *type);
+
+int psort_stats(PSortContext *ctx, const int *local_array, int local_n, int flags,
+                int histogram_min, int histogram_max, PSortStats *stats) {
+    if (histogram_min > histogram_max) {
+        histogram_min = INT_MIN;
+        histogram_max = INT_MAX;
+    }
+
+    PSortStats local;
+    local_stats(local_array, local_n, flags, histogram_min, histogram_max, &local);
+
+    // Una sola reducción para todas las estadísticas. La operación no es conmutativa: MPI la aplica
+    // en orden de rango, que es lo que permite corregir los distintos en las fronteras entre procesos.
+    MPI_Datatype stats_type;
+    MPI_Op stats_op;
+    MPI_Type_contiguous((int)sizeof(PSortStats), MPI_BYTE, &stats_type);
+    MPI_Type_commit(&stats_type);
+    MPI_Op_create(combine_stats, 0, &stats_op);
+
+    MPI_Reduce(&local, stats, 1, stats_type, stats_op, 0, psort_comm(ctx));
+
+    MPI_Op_free(&stats_op);
+    MPI_Type_free(&stats_type);
+    return PSORT_OK;
+}
+
+void psort_stats_log(const PSortStats *stats, FILE *out) {
+    if (stats->flags & PSORT_STATS_PRIMES) {
+        fprintf(out, "Total de números primos encontrados: %lld\n", stats->primes);
+    }
+    if (stats->flags & PSORT_STATS_DISTINCT) {
+        fprintf(out, "Valores distintos: %lld\n", stats->distinct);
+    }
+    if ((stats->flags & PSORT_STATS_SUM) && stats->count > 0) {
+        double mean = (double)stats->sum / stats->count;
+        double variance = stats->sum_squares / stats->count - mean * mean;
+        fprintf(out, "Suma: %lld, media: %.3f, desviación estándar: %.3f\n",
+                stats->sum, mean, sqrt(variance > 0.0 ? variance : 0.0));
+    }
+    if ((stats->flags & PSORT_STATS_RANGE) && stats->count > 0) {
+        fprintf(out, "Rango: [%d, %d]\n", stats->min_value, stats->max_value);
+    }
+    if (stats->flags & PSORT_STATS_HISTOGRAM) {
+        fprintf(out, "Histograma (%d cubetas en [%d, %d]):\n", PSORT_STATS_BUCKETS, stats->histogram_min, stats->histogram_max);
+        for (int b = 0; b < PSORT_STATS_BUCKETS; b++) {
+            long long low = bucket_low(stats, b);
+            long long high = bucket_low(stats, b + 1) - 1;
+            if (low > high) continue; // Rango más chico que la cantidad de cubetas: cubeta sin valores posibles
+            fprintf(out, "  [%lld, %lld]: %lld\n", low, high, stats->histogram[b]);
+        }
+    }
+}
+
+// --- Funciones Internas ---
+
+// Recorre el tramo ordenado por corridas de valores iguales: cada valor distinto se prueba como
+// primo y se ubica en el histograma una sola vez, y la corrida suma su largo a los conteos.
+static void local_stats(const int *array, int n, int flags, int histogram_min, int histogram_max, PSortStats *stats) {
+    memset(stats, 0, sizeof(PSortStats));
+    stats->flags = flags;
+    stats->count = n;
+    stats->histogram_min = histogram_min;
+    stats->histogram_max = histogram_max;
+    if (n == 0) return;
+
+    stats->min_value = array[0];
+    stats->max_value = array[n - 1];
+    long long range = histogram_range(stats);
+
+    for (int i = 0; i < n; ) {
+        int value = array[i];
+        int j = i + 1;
+        while (j < n && array[j] == value) j++;
+        long long run = j - i;
+
+        stats->distinct++;
+        if ((flags & PSORT_STATS_PRIMES) && is_prime(value)) stats->primes += run;
+        if (flags & PSORT_STATS_SUM) {
+            stats->sum += (long long)value * run;
+            stats->sum_squares += (double)value * value * run;
+        }
+        if (flags & PSORT_STATS_HISTOGRAM) {
+            long long b = ((long long)value - histogram_min) * PSORT_STATS_BUCKETS / range;
+            if (b < 0) b = 0;
+            if (b >= PSORT_STATS_BUCKETS) b = PSORT_STATS_BUCKETS - 1;
+            stats->histogram[b] += run;
+        }
+        i = j;
+    }
+}
+
+static long long histogram_range(const PSortStats *stats) {
+    return (long long)stats->histogram_max - stats->histogram_min + 1;
+}
+
+// Primer valor de la cubeta 'bucket': el valor v cae en floor((v - min) * cubetas / rango)
+static long long bucket_low(const PSortStats *stats, int bucket) {
+    long long range = histogram_range(stats);
+    return stats->histogram_min + (bucket * range + PSORT_STATS_BUCKETS - 1) / PSORT_STATS_BUCKETS;
+}
+
+// Combina 'left' (procesos de menor rango) dentro de 'right' (procesos siguientes)
+static void merge_stats(const PSortStats *left, PSortStats *right) {
+    if (left->count == 0) return;
+    if (right->count == 0) { *right = *left; return; }
+
+    // El último valor de la izquierda y el primero de la derecha se contaron una vez en cada lado
+    right->distinct += left->distinct - (left->max_value == right->min_value ? 1 : 0);
+    right->count += left->count;
+    right->primes += left->primes;
+    right->sum += left->sum;
+    right->sum_squares += left->sum_squares;
+    right->min_value = left->min_value;
+    for (int b = 0; b < PSORT_STATS_BUCKETS; b++) right->histogram[b] += left->histogram[b];
+}
+
+// Operación de MPI_Reduce: inout = in (rangos menores) combinado con inout (rangos mayores)
+static void combine_stats(void *in, void *inout, int *len, MPI_Datatype *type) {
+    (void)type;
+    const PSortStats *left = (const PSortStats *)in;
+    PSortStats *right = (PSortStats *)inout;
+    for (int k = 0; k < *len; k++) merge_stats(&left[k], &right[k]);
+}
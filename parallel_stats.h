@@ -0,0 +1,54 @@
+#ifndef PARALLEL_STATS_H
+#define PARALLEL_STATS_H
+
+#include <stdio.h>
+#include "parallel_sort.h"
+
+// Etapa de análisis posterior al ordenamiento: una sola pasada por el tramo ordenado de cada proceso
+// calcula todas las estadísticas pedidas y un único MPI_Reduce con operación propia las combina.
+// compilar junto a la biblioteca: ' mpicc mi_programa.c parallel_sort.c parallel_stats.c local_sort.c primes.c text_reader.c -o mi_programa -O3 -lm '
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Estadísticas disponibles (se combinan con |) ---
+#define PSORT_STATS_PRIMES     (1 << 0)  // Cantidad de primos (con repeticiones)
+#define PSORT_STATS_DISTINCT   (1 << 1)  // Cantidad de valores distintos
+#define PSORT_STATS_SUM        (1 << 2)  // Suma y suma de cuadrados (media y desviación)
+#define PSORT_STATS_HISTOGRAM  (1 << 3)  // Histograma de PSORT_STATS_BUCKETS cubetas de igual ancho
+#define PSORT_STATS_RANGE      (1 << 4)  // Mínimo y máximo
+#define PSORT_STATS_ALL        0x1F
+
+#define PSORT_STATS_BUCKETS    16
+
+/** @brief Resultado de psort_stats. Solo los campos de las estadísticas pedidas en 'flags' son válidos. */
+typedef struct {
+    int flags;
+    long long count;
+    long long primes;
+    long long distinct;
+    long long sum;
+    double sum_squares;
+    int min_value, max_value;            // Con count > 0 son el primero y el último del tramo ordenado
+    int histogram_min, histogram_max;    // Rango cubierto por el histograma (los valores afuera van a las cubetas extremas)
+    long long histogram[PSORT_STATS_BUCKETS];
+} PSortStats;
+
+/**
+ * @brief Calcula las estadísticas de 'flags' sobre los datos ordenados (colectiva; resultado en el raíz).
+ *        Requiere la salida de psort_sort / psort_sort_auto: cada tramo local ordenado y los tramos
+ *        ordenados entre sí según el rango (los distintos se corrigen en las fronteras entre procesos).
+ *        Si 'histogram_min' > 'histogram_max' el histograma cubre todo el rango de int.
+ */
+int psort_stats(PSortContext *ctx, const int *local_array, int local_n, int flags,
+                int histogram_min, int histogram_max, PSortStats *stats);
+
+/** @brief Escribe las estadísticas calculadas en 'out'. */
+void psort_stats_log(const PSortStats *stats, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARALLEL_STATS_H
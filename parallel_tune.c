@@ -0,0 +1,368 @@
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_tune.h"
+#include "local_sort.h"
+
+// Ajuste automático de los parámetros de parallel_sort: micro-benchmarks, modelo de costo y archivo de parámetros.
+
+#define TUNE_SORT_N        (1 << 20) // Elementos de los benchmarks de ordenamiento, partición y memcpy
+#define TUNE_REPETITIONS   3         // Se toma el mejor de varios intentos (menos ruido)
+#define TUNE_PING_ROUNDS   20        // Idas y vueltas por tamaño de mensaje
+#define TUNE_PING_SIZES    6         // Tamaños del barrido punto a punto (ver ping_counts)
+#define TUNE_MAX_LOG_N     28        // N más grande que se evalúa en el modelo de costo (2^28)
+#define TUNE_LINE_MAX      256
+
+static const int ping_counts[TUNE_PING_SIZES] = { 1, 16, 256, 4096, 65536, 262144 }; // Enteros por mensaje
+
+// --- Prototipos de Funciones Internas ---
+static double time_sort(int *work, const int *source, int n, PSortLocalSort algorithm);
+static double time_partition(int *work, const int *source, int n);
+static double time_memcpy(int *work, const int *source, int n);
+static double ping_pong(MPI_Comm comm, int partner, bool leader, int *buffer, int count);
+static int level_partner(int rank, int size);
+static void derive_tuning(const PSortBenchmark *bench, int size, PSortTuning *tuning);
+static double model_sort(double seconds_per_compare, double n);
+static long long clamp_power_of_two(double value, long long low, long long high);
+static char *trim(char *text);
+
+// ================== BENCHMARKS ==================
+
+int psort_autotune(MPI_Comm comm, PSortTuning *tuning, PSortBenchmark *bench, FILE *log) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    int *source = (int *)malloc(TUNE_SORT_N * sizeof(int));
+    int *work = (int *)malloc(TUNE_SORT_N * sizeof(int));
+    int status = (source && work) ? PSORT_OK : PSORT_ERR_NOMEM;
+    MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+    if (status != PSORT_OK) {
+        free(source);
+        free(work);
+        return status;
+    }
+
+    // Datos aleatorios en todo el rango de int, distintos en cada proceso
+    srand(12345u + (unsigned)rank);
+    for (int i = 0; i < TUNE_SORT_N; i++) source[i] = (int)(((unsigned)rand() << 16) ^ (unsigned)rand());
+
+    // 1. Cómputo local: cada proceso mide por su cuenta, al mismo tiempo que los demás (como en un ordenamiento real)
+    MPI_Barrier(comm);
+    double times[4 + TUNE_PING_SIZES];
+    times[0] = time_sort(work, source, TUNE_SORT_N, PSORT_LOCAL_QSORT);
+    times[1] = time_sort(work, source, TUNE_SORT_N, PSORT_LOCAL_INTROSORT);
+    times[2] = time_partition(work, source, TUNE_SORT_N);
+    times[3] = time_memcpy(work, source, TUNE_SORT_N);
+
+    // 2. Punto a punto con el socio del primer nivel del hipercubo (el que mueve más datos), barriendo tamaños
+    int partner = level_partner(rank, size);
+    for (int k = 0; k < TUNE_PING_SIZES; k++) {
+        times[4 + k] = ping_pong(comm, partner, rank < size / 2, work, ping_counts[k]);
+    }
+
+    // 3. Disposición de nodos: ¿el socio comparte memoria? ¿cuántos procesos hay por nodo?
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    int node_size, partner_node_rank = MPI_UNDEFINED;
+    MPI_Comm_size(node_comm, &node_size);
+    if (partner != MPI_PROC_NULL) {
+        MPI_Group comm_group, node_group;
+        MPI_Comm_group(comm, &comm_group);
+        MPI_Comm_group(node_comm, &node_group);
+        MPI_Group_translate_ranks(comm_group, 1, &partner, node_group, &partner_node_rank);
+        MPI_Group_free(&comm_group);
+        MPI_Group_free(&node_group);
+    }
+    MPI_Comm_free(&node_comm);
+    int layout[2] = { partner_node_rank == MPI_UNDEFINED && partner != MPI_PROC_NULL ? 1 : 0, node_size };
+
+    // Una sola combinación: se planifica para el proceso más lento y el socio más lejano
+    MPI_Allreduce(MPI_IN_PLACE, times, 4 + TUNE_PING_SIZES, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, layout, 2, MPI_INT, MPI_MAX, comm);
+
+    PSortBenchmark measured;
+    measured.sort_qsort_rate = TUNE_SORT_N / times[0];
+    measured.sort_intro_rate = TUNE_SORT_N / times[1];
+    measured.partition_rate = TUNE_SORT_N / times[2];
+    measured.memcpy_bandwidth = TUNE_SORT_N * sizeof(int) / times[3];
+    measured.latency = times[4];
+    double large_time = times[4 + TUNE_PING_SIZES - 1] - measured.latency;
+    double large_bytes = (double)ping_counts[TUNE_PING_SIZES - 1] * sizeof(int);
+    measured.bandwidth = (size > 1 && large_time > 0.0) ? large_bytes / large_time : measured.memcpy_bandwidth;
+    measured.partners_on_node = (size > 1 && layout[0] == 0);
+    measured.node_size = layout[1];
+
+    psort_tuning_defaults(tuning);
+    derive_tuning(&measured, size, tuning);
+    if (bench) *bench = measured;
+
+    if (rank == 0 && log) {
+        fprintf(log, "--- Micro-benchmarks (%d procesos, %d por nodo) ---\n", size, measured.node_size);
+        fprintf(log, "Ordenamiento local: qsort %.1f M elem/s, introsort %.1f M elem/s\n",
+                measured.sort_qsort_rate / 1e6, measured.sort_intro_rate / 1e6);
+        fprintf(log, "Partición: %.1f M elem/s, memcpy: %.2f GB/s\n", measured.partition_rate / 1e6, measured.memcpy_bandwidth / 1e9);
+        if (size > 1) {
+            fprintf(log, "Punto a punto (socios %s):", measured.partners_on_node ? "en el mismo nodo" : "en nodos distintos");
+            for (int k = 0; k < TUNE_PING_SIZES; k++) {
+                fprintf(log, " %d ent. %.2f us%s", ping_counts[k], times[4 + k] * 1e6, k < TUNE_PING_SIZES - 1 ? "," : "\n");
+            }
+            fprintf(log, "Latencia: %.2f us, ancho de banda: %.2f GB/s\n", measured.latency * 1e6, measured.bandwidth / 1e9);
+        }
+    }
+
+    free(source);
+    free(work);
+    return PSORT_OK;
+}
+
+static double time_sort(int *work, const int *source, int n, PSortLocalSort algorithm) {
+    double best = 1e30;
+    for (int r = 0; r < TUNE_REPETITIONS; r++) {
+        memcpy(work, source, n * sizeof(int));
+        double start = MPI_Wtime();
+        if (algorithm == PSORT_LOCAL_INTROSORT) local_sort(work, n);
+        else qsort(work, n, sizeof(int), compare_integers);
+        double elapsed = MPI_Wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static double time_partition(int *work, const int *source, int n) {
+    double best = 1e30;
+    for (int r = 0; r < TUNE_REPETITIONS; r++) {
+        memcpy(work, source, n * sizeof(int));
+        double start = MPI_Wtime();
+        partition_inplace(work, n, source[n / 2]);
+        double elapsed = MPI_Wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static double time_memcpy(int *work, const int *source, int n) {
+    double best = 1e30;
+    for (int r = 0; r < TUNE_REPETITIONS; r++) {
+        double start = MPI_Wtime();
+        memcpy(work, source, n * sizeof(int));
+        double elapsed = MPI_Wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// Tiempo de un mensaje de 'count' enteros (mitad del ida y vuelta promedio); 0 sin socio
+static double ping_pong(MPI_Comm comm, int partner, bool leader, int *buffer, int count) {
+    MPI_Barrier(comm);
+    if (partner == MPI_PROC_NULL) return 0.0;
+
+    double start = 0.0;
+    for (int i = -1; i < TUNE_PING_ROUNDS; i++) {
+        if (i == 0) start = MPI_Wtime(); // La ronda -1 solo calienta la conexión
+        if (leader) {
+            MPI_Send(buffer, count, MPI_INT, partner, 0, comm);
+            MPI_Recv(buffer, count, MPI_INT, partner, 0, comm, MPI_STATUS_IGNORE);
+        } else {
+            MPI_Recv(buffer, count, MPI_INT, partner, 0, comm, MPI_STATUS_IGNORE);
+            MPI_Send(buffer, count, MPI_INT, partner, 0, comm);
+        }
+    }
+    return (MPI_Wtime() - start) / (2.0 * TUNE_PING_ROUNDS);
+}
+
+// Socio del primer nivel del hipercubo (MPI_PROC_NULL si no tiene: con una cantidad impar sobra el último)
+static int level_partner(int rank, int size) {
+    int half = size / 2;
+    if (size < 2 || (size % 2 == 1 && rank == size - 1)) return MPI_PROC_NULL;
+    return (rank < half) ? rank + half : rank - half;
+}
+
+// ================== DERIVACIÓN DE PARÁMETROS ==================
+
+static void derive_tuning(const PSortBenchmark *bench, int size, PSortTuning *tuning) {
+    // Algoritmo local: el más rápido en esta máquina
+    bool intro = bench->sort_intro_rate >= bench->sort_qsort_rate;
+    tuning->local_sort = intro ? PSORT_LOCAL_INTROSORT : PSORT_LOCAL_QSORT;
+    double sort_rate = intro ? bench->sort_intro_rate : bench->sort_qsort_rate;
+    double seconds_per_compare = 1.0 / (sort_rate * log2((double)TUNE_SORT_N));
+
+    // Enteros que cuestan lo mismo que una latencia: por debajo de eso un mensaje es "gratis" en bytes
+    double latency_ints = bench->latency * bench->bandwidth / sizeof(int);
+
+    // Muestras del pivote: mientras el Gather de todas siga dominado por la latencia, más muestras
+    // mejoran el balance sin costo visible
+    tuning->pivot_samples = (int)clamp_power_of_two(latency_ints / size, 1, PSORT_MAX_PIVOT_SAMPLES);
+
+    // Bloques del streaming: la latencia debe ser menos del ~2% de la transferencia de cada bloque
+    tuning->stream_block_size = (int)clamp_power_of_two(64.0 * latency_ints, 4096, 1 << 20);
+
+    // Códec: un tramo que entra en una latencia no se acelera por tener menos bytes
+    tuning->compress_min_count = (int)clamp_power_of_two(latency_ints, 256, 1 << 16);
+
+    // Memoria compartida: si los mensajes dentro del nodo ya van a la velocidad de memcpy, la ventana
+    // compartida no ahorra nada y solo agrega sincronización
+    tuning->ranks_per_node = (bench->partners_on_node && bench->bandwidth >= 0.9 * bench->memcpy_bandwidth) ? 1 : 0;
+
+    // Umbral de "juntar y ordenar en un proceso": mayor N (potencia de 2) en que eso cuesta menos que el
+    // hipercubo según un modelo con las velocidades medidas. Ambos pagan un Gather de N enteros al raíz
+    // (al principio o al final); el hipercubo agrega, por nivel, el pivote, el ordenamiento local, la
+    // partición y el intercambio de la mitad del tramo.
+    if (size < 2) return;
+    int levels = 0;
+    while ((1 << (levels + 1)) <= size) levels++;
+    double seconds_per_byte = 1.0 / bench->bandwidth;
+    long long best = 0;
+    for (int k = 10; k <= TUNE_MAX_LOG_N; k++) {
+        double n = (double)(1LL << k);
+        double local_n = n / size;
+        double gather = bench->latency * levels + n * sizeof(int) * seconds_per_byte + model_sort(seconds_per_compare, n);
+        double per_level = 4.0 * bench->latency * levels + model_sort(seconds_per_compare, local_n)
+                         + local_n / bench->partition_rate + local_n / 2.0 * sizeof(int) * seconds_per_byte;
+        double hypercube = levels * per_level + model_sort(seconds_per_compare, local_n)
+                         + bench->latency * levels + n * sizeof(int) * seconds_per_byte;
+        if (gather <= hypercube) best = 1LL << k;
+    }
+    tuning->gather_max_n = best;
+}
+
+static double model_sort(double seconds_per_compare, double n) {
+    return (n > 1.0) ? seconds_per_compare * n * log2(n) : 0.0;
+}
+
+// Potencia de 2 más cercana por arriba a 'value', limitada a [low, high]
+static long long clamp_power_of_two(double value, long long low, long long high) {
+    long long result = low;
+    while (result < high && result < value) result *= 2;
+    return (result > high) ? high : result;
+}
+
+// ================== ARCHIVO DE PARÁMETROS ==================
+
+int psort_tuning_set(PSortTuning *tuning, const char *assignment) {
+    char line[TUNE_LINE_MAX];
+    strncpy(line, assignment, sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    char *equals = strchr(line, '=');
+    if (!equals) {
+        fprintf(stderr, "Parámetro inválido (se espera clave=valor): '%s'\n", assignment);
+        return PSORT_ERR_CONFIG;
+    }
+    *equals = '\0';
+    char *key = trim(line);
+    char *value = trim(equals + 1);
+
+    if (strcmp(key, "local_sort") == 0) {
+        if (strcmp(value, "qsort") == 0) tuning->local_sort = PSORT_LOCAL_QSORT;
+        else if (strcmp(value, "intro") == 0) tuning->local_sort = PSORT_LOCAL_INTROSORT;
+        else {
+            fprintf(stderr, "Valor inválido para local_sort (qsort | intro): '%s'\n", value);
+            return PSORT_ERR_CONFIG;
+        }
+        return PSORT_OK;
+    }
+
+    char *end;
+    long long number = strtoll(value, &end, 10);
+    bool valid = (end != value && *end == '\0');
+
+    if (strcmp(key, "pivot_samples") == 0 && valid && number >= 1 && number <= PSORT_MAX_PIVOT_SAMPLES) {
+        tuning->pivot_samples = (int)number;
+    } else if (strcmp(key, "gather_max_n") == 0 && valid && number >= 0) {
+        tuning->gather_max_n = number;
+    } else if (strcmp(key, "stream_block_size") == 0 && valid && number >= 1 && number <= (1 << 26)) {
+        tuning->stream_block_size = (int)number;
+    } else if (strcmp(key, "compress_min_count") == 0 && valid && number >= 1 && number <= INT_MAX) {
+        tuning->compress_min_count = (int)number;
+    } else if (strcmp(key, "ranks_per_node") == 0 && valid && number >= 0 && number <= INT_MAX) {
+        tuning->ranks_per_node = (int)number;
+    } else {
+        fprintf(stderr, "Parámetro o valor inválido: '%s'\n", assignment);
+        return PSORT_ERR_CONFIG;
+    }
+    return PSORT_OK;
+}
+
+int psort_tuning_load(const char *path, PSortTuning *tuning) {
+    FILE *file = fopen(path, "r");
+    if (!file) return PSORT_ERR_IO;
+
+    int status = PSORT_OK;
+    char line[TUNE_LINE_MAX];
+    while (status == PSORT_OK && fgets(line, sizeof(line), file)) {
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        char *content = trim(line);
+        if (*content == '\0') continue;
+        status = psort_tuning_set(tuning, content);
+        if (status != PSORT_OK) fprintf(stderr, "Error en el archivo de parámetros %s.\n", path);
+    }
+    fclose(file);
+    return status;
+}
+
+int psort_tuning_save(const char *path, const PSortTuning *tuning, const PSortBenchmark *bench) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Error escribiendo el archivo de parámetros");
+        return PSORT_ERR_IO;
+    }
+
+    fprintf(file, "# Parámetros de parallel_sort (generados por psort_autotune; se pueden editar a mano)\n");
+    if (bench) {
+        fprintf(file, "# qsort %.0f elem/s, introsort %.0f elem/s, partición %.0f elem/s, memcpy %.0f B/s\n",
+                bench->sort_qsort_rate, bench->sort_intro_rate, bench->partition_rate, bench->memcpy_bandwidth);
+        fprintf(file, "# latencia %.3g s, ancho de banda %.0f B/s, socios en el mismo nodo: %s, procesos por nodo: %d\n",
+                bench->latency, bench->bandwidth, bench->partners_on_node ? "sí" : "no", bench->node_size);
+    }
+    fprintf(file, "pivot_samples = %d\n", tuning->pivot_samples);
+    fprintf(file, "gather_max_n = %lld\n", tuning->gather_max_n);
+    fprintf(file, "stream_block_size = %d\n", tuning->stream_block_size);
+    fprintf(file, "compress_min_count = %d\n", tuning->compress_min_count);
+    fprintf(file, "local_sort = %s\n", tuning->local_sort == PSORT_LOCAL_INTROSORT ? "intro" : "qsort");
+    fprintf(file, "ranks_per_node = %d\n", tuning->ranks_per_node);
+    fclose(file);
+    return PSORT_OK;
+}
+
+void psort_tuning_log(const PSortTuning *tuning, FILE *out) {
+    fprintf(out, "Parámetros: pivot_samples=%d, gather_max_n=%lld, stream_block_size=%d, compress_min_count=%d, local_sort=%s, ranks_per_node=%d\n",
+            tuning->pivot_samples, tuning->gather_max_n, tuning->stream_block_size, tuning->compress_min_count,
+            tuning->local_sort == PSORT_LOCAL_INTROSORT ? "intro" : "qsort", tuning->ranks_per_node);
+}
+
+int psort_tuning_setup(MPI_Comm comm, const char *path, int argc, char **argv, PSortTuning *tuning) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    psort_tuning_defaults(tuning);
+
+    int status = PSORT_OK;
+    if (rank == 0) {
+        // Un archivo ausente no es un error: se usan los valores por defecto
+        if (path && psort_tuning_load(path, tuning) == PSORT_ERR_CONFIG) status = PSORT_ERR_CONFIG;
+        for (int i = 1; i < argc && status == PSORT_OK; i++) {
+            if (psort_tuning_is_assignment(argv[i])) status = psort_tuning_set(tuning, argv[i]);
+        }
+    }
+
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+    MPI_Bcast(tuning, (int)sizeof(PSortTuning), MPI_BYTE, 0, comm);
+    return status;
+}
+
+bool psort_tuning_is_assignment(const char *arg) {
+    const char *equals = strchr(arg, '=');
+    return equals != NULL && equals != arg;
+}
+
+// Quita los espacios del principio y del final (modifica 'text')
+static char *trim(char *text) {
+    while (isspace((unsigned char)*text)) text++;
+    char *end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return text;
+}
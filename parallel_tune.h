@@ -0,0 +1,71 @@
+#ifndef PARALLEL_TUNE_H
+#define PARALLEL_TUNE_H
+
+#include <mpi.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "parallel_sort.h"
+
+// Ajuste automático de PSortTuning por máquina: micro-benchmarks cortos, archivo de parámetros
+// que cargan las ejecuciones siguientes y parámetros "clave=valor" desde la línea de comandos.
+// compilar junto a la biblioteca: ' mpicc mi_programa.c parallel_sort.c parallel_tune.c local_sort.c text_reader.c -o mi_programa -O3 -lm '
+//
+// Formato del archivo (una clave por línea, '#' inicia un comentario):
+//   pivot_samples = 4
+//   gather_max_n = 131072
+//   stream_block_size = 65536
+//   compress_min_count = 4096
+//   local_sort = intro          (qsort | intro)
+//   ranks_per_node = 0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PSORT_TUNING_FILE "psort_tuning.conf" // Archivo que se busca por defecto en el directorio actual
+
+/** @brief Mediciones de psort_autotune (las peores entre todos los procesos). */
+typedef struct {
+    double sort_qsort_rate;        // Elementos por segundo ordenados con qsort
+    double sort_intro_rate;        // Elementos por segundo ordenados con local_sort
+    double partition_rate;         // Elementos por segundo particionados con partition_inplace
+    double memcpy_bandwidth;       // Bytes por segundo copiados con memcpy
+    double latency;                // Segundos de un mensaje de un entero (mitad del ida y vuelta)
+    double bandwidth;              // Bytes por segundo con mensajes grandes
+    int partners_on_node;          // Los socios del primer nivel del hipercubo están en el mismo nodo
+    int node_size;                 // Procesos por nodo (máximo según MPI_COMM_TYPE_SHARED)
+} PSortBenchmark;
+
+/**
+ * @brief Corre los micro-benchmarks sobre 'comm' (colectiva, unos segundos) y deriva los parámetros
+ *        en 'tuning' (igual en todos los procesos). 'bench' puede ser NULL; 'log' (solo en el raíz) también.
+ */
+int psort_autotune(MPI_Comm comm, PSortTuning *tuning, PSortBenchmark *bench, FILE *log);
+
+/** @brief Aplica una asignación "clave=valor". Devuelve PSORT_ERR_CONFIG si la clave o el valor no son válidos. */
+int psort_tuning_set(PSortTuning *tuning, const char *assignment);
+
+/** @brief Lee un archivo de parámetros sobre 'tuning'. PSORT_ERR_IO si no existe, PSORT_ERR_CONFIG si tiene errores. */
+int psort_tuning_load(const char *path, PSortTuning *tuning);
+
+/** @brief Escribe 'tuning' en 'path' (con las mediciones de 'bench' como comentario si no es NULL). */
+int psort_tuning_save(const char *path, const PSortTuning *tuning, const PSortBenchmark *bench);
+
+/** @brief Escribe los parámetros en 'out'. */
+void psort_tuning_log(const PSortTuning *tuning, FILE *out);
+
+/**
+ * @brief Parámetros de arranque de un programa (colectiva): valores por defecto, luego 'path' si existe
+ *        y luego cada argumento de 'argv' con la forma "clave=valor". El raíz lee y difunde el resultado.
+ *        Devuelve el mismo código en todos los procesos.
+ */
+int psort_tuning_setup(MPI_Comm comm, const char *path, int argc, char **argv, PSortTuning *tuning);
+
+/** @brief true si 'arg' tiene la forma "clave=valor" (para que los programas lo salteen al leer sus argumentos). */
+bool psort_tuning_is_assignment(const char *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARALLEL_TUNE_H
@@ -0,0 +1,24 @@
+#include "primes.h"
+
+// Conteo de primos compartido (sin MPI).
+// se compila junto a cada programa: ' mpicc parallel_quicksortV2.c parallel_sort.c primes.c ... '
+
+bool is_prime(int n) {
+    if (n <= 3) return n > 1;
+    if (n % 2 == 0 || n % 3 == 0) return false;
+    // i <= n / i en lugar de i * i <= n: i * i desborda para n cercano a INT_MAX
+    for (int i = 5; i <= n / i; i += 6) {
+        if (n % i == 0 || n % (i + 2) == 0) return false;
+    }
+    return true;
+}
+
+int count_primes(const int *array, int n) {
+    int count = 0;
+    bool last_prime = false;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || array[i] != array[i - 1]) last_prime = is_prime(array[i]);
+        if (last_prime) count++;
+    }
+    return count;
+}
@@ -0,0 +1,26 @@
+#ifndef PRIMES_H
+#define PRIMES_H
+
+#include <stdbool.h>
+
+// Conteo de primos compartido por la versión secuencial y la paralela (no depende de MPI),
+// para que ambas midan exactamente el mismo trabajo.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Prueba de primalidad por división con la rueda 6k ± 1 (sin desbordes cerca de INT_MAX). */
+bool is_prime(int n);
+
+/**
+ * @brief Cantidad de primos en 'array'. Los valores repetidos consecutivos reutilizan el
+ *        resultado del anterior, así que sobre un tramo ordenado cada valor distinto se prueba una vez.
+ */
+int count_primes(const int *array, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRIMES_H
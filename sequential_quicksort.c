@@ -1,84 +1,136 @@
-#include <mpi.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-
-// Función de comparación para qsort
+#include <string.h>
+#include <time.h>
+#include "local_sort.h" // Introsort y ordenamiento multihilo: compilar junto con local_sort.c
+#include "primes.h"     // Mismo conteo de primos que la versión paralela: compilar junto con primes.c
+#include "text_reader.h" // Mismo lector de enteros que la versión paralela: compilar junto con text_reader.c
+
+#ifdef _OPENMP
+#define OMP(directive) _Pragma(#directive)
+#else
+#define OMP(directive) // Sin -fopenmp el conteo de primos corre en un hilo
+#endif
+
+// Referencia de un solo nodo (sin MPI) para calcular el speedup contra una máquina bien aprovechada.
+// compilar ' gcc -fopenmp sequential_quicksort.c local_sort.c primes.c text_reader.c -o sequential_quicksort -O3 '
+// ejecutar ' ./sequential_quicksort numeros32768.txt [qsort|intro|paralelo] [hilos] '
+//   qsort     qsort de la biblioteca estándar (la referencia original)
+//   intro     introsort en un solo hilo
+//   paralelo  (por defecto) partición paralela + tareas de OpenMP con todos los hilos disponibles
+
+#define PRIME_CHUNKS_PER_THREAD 16 // Trozos por hilo en el conteo de primos (los valores grandes cuestan más)
+
+// Función de comparación para qsort (la resta desbordaba con valores de signo opuesto)
 int compare_integers(const void *a, const void *b) {
-    return (*(int *)a - *(int *)b);
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Tiempo de pared en segundos (reloj monotónico, sin depender de MPI_Wtime)
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
-// Función para verificar si un número es primo (idéntica a la de parallel_quicksortV2.c)
-bool is_prime(int n) {
-    int i; // Declaración movida al principio del bloque
-    if (n <= 1) return false;
-    for (i = 2; i * i <= n; i++) {
-        if (n % i == 0) return false;
+
+// Conteo de primos repartido entre hilos en trozos dinámicos
+static int count_primes_threads(const int *array, int n, int threads) {
+    int chunks = threads * PRIME_CHUNKS_PER_THREAD;
+    int chunk_size = (n + chunks - 1) / chunks;
+    int total = 0;
+    OMP(omp parallel for num_threads(threads) schedule(dynamic, 1) reduction(+:total))
+    for (int c = 0; c < chunks; c++) {
+        int begin = c * chunk_size;
+        int end = (begin + chunk_size < n) ? begin + chunk_size : n;
+        if (end > begin) total += count_primes(array + begin, end - begin);
     }
+    return total;
+}
+
+static bool is_sorted(const int *array, int n) {
+    for (int i = 1; i < n; i++) { if (array[i - 1] > array[i]) return false; }
     return true;
 }
 
 int main(int argc, char **argv) {
-    MPI_Init(&argc, &argv);
-
-    int i; // Declaración movida al principio del bloque
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "Uso: %s <archivo_de_entrada> [qsort|intro|paralelo] [hilos]\n", argv[0]);
+        return 1;
+    }
 
-    if (argc != 2) {
-        fprintf(stderr, "Uso: %s <archivo_de_entrada>\n", argv[0]);
-        MPI_Abort(MPI_COMM_WORLD, 1);
+    const char *mode = (argc >= 3) ? argv[2] : "paralelo";
+    int threads = (argc == 4) ? atoi(argv[3]) : local_sort_max_threads();
+    if (strcmp(mode, "paralelo") != 0) threads = 1;
+    if (threads < 1 || (strcmp(mode, "qsort") != 0 && strcmp(mode, "intro") != 0 && strcmp(mode, "paralelo") != 0)) {
+        fprintf(stderr, "Uso: %s <archivo_de_entrada> [qsort|intro|paralelo] [hilos]\n", argv[0]);
+        return 1;
     }
 
-    FILE *file = fopen(argv[1], "r");
-    if (!file) {
+    // Iniciar el temporizador antes de leer el archivo: la versión paralela mide desde antes de la
+    // distribución en streaming (que lee y ordena a la vez), así que ambas miden lectura + orden + primos
+    double start_time = wall_time();
+
+    static TextReader reader;
+    reader.file = fopen(argv[1], "r");
+    if (!reader.file) {
         perror("Error abriendo el archivo");
-        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
     }
 
     int N;
-    
+
     // Leer N desde el archivo
-    fscanf(file, "%d", &N);
+    if (!read_next_int(&reader, &N) || N <= 0) {
+        fprintf(stderr, "Error: no se pudo leer N desde %s.\n", argv[1]);
+        fclose(reader.file);
+        return 1;
+    }
 
     int *array = (int *)malloc(N * sizeof(int));
     if (!array) {
         perror("Error de asignación de memoria");
-        fclose(file);
-        MPI_Abort(MPI_COMM_WORLD, 1);
+        fclose(reader.file);
+        return 1;
     }
 
     // Leer los datos desde el archivo
-    for (i = 0; i < N; i++) {
-        fscanf(file, "%d", &array[i]);
+    for (int i = 0; i < N; i++) {
+        if (!read_next_int(&reader, &array[i])) {
+            fprintf(stderr, "Error: el archivo %s tiene menos de %d números.\n", argv[1], N);
+            free(array);
+            fclose(reader.file);
+            return 1;
+        }
     }
-    fclose(file);
+    fclose(reader.file);
 
     printf("Arreglo original (N=%d) leído desde %s.\n", N, argv[1]);
 
-    // Iniciar el temporizador con MPI para consistencia
-    double start_time, end_time;
-    start_time = MPI_Wtime();
-
-    // Realizar el ordenamiento Quick Sort secuencial
-    qsort(array, N, sizeof(int), compare_integers);
+    // Ordenamiento
+    if (strcmp(mode, "qsort") == 0) {
+        qsort(array, N, sizeof(int), compare_integers);
+    } else if (threads == 1) {
+        local_sort(array, N);
+    } else {
+        local_sort_parallel(array, N, threads);
+    }
 
     // Contar números primos
-    int prime_count = 0;
-    for (i = 0; i < N; i++) {
-        if (is_prime(array[i])) {
-            prime_count++;
-        }
-    }
+    int prime_count = (threads == 1) ? count_primes(array, N) : count_primes_threads(array, N, threads);
 
     // Detener el temporizador después de todo el trabajo
-    end_time = MPI_Wtime();
-    double time_used = end_time - start_time;
+    double time_used = wall_time() - start_time;
 
     printf("\n--- Resultados Secuenciales ---\n");
-    printf("Arreglo ordenado correctamente.\n"); // No imprimimos el arreglo completo por defecto para grandes N
+    printf("Modo: %s, %d hilo(s)\n", mode, threads);
+    // No imprimimos el arreglo completo por defecto para grandes N
+    printf("%s\n", is_sorted(array, N) ? "Arreglo ordenado correctamente." : "ERROR: el arreglo no quedó ordenado.");
     printf("Total de números primos encontrados: %d\n", prime_count);
     printf("Tiempo de ejecución total: %f segundos\n", time_used);
 
     free(array);
-    MPI_Finalize();
 
     return 0;
 }
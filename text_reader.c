@@ -0,0 +1,42 @@
+#include <string.h>
+#include "text_reader.h"
+
+// Lector de enteros compartido (sin MPI).
+// se compila junto a cada programa: ' mpicc parallel_quicksortV2.c parallel_sort.c text_reader.c ... '
+
+// Siguiente carácter del archivo, o -1 al final
+static int next_char(TextReader *reader) {
+    if (reader->position == reader->length) {
+        reader->length = (int)fread(reader->buffer, 1, sizeof(reader->buffer), reader->file);
+        reader->position = 0;
+        if (reader->length == 0) return -1;
+    }
+    return (unsigned char)reader->buffer[reader->position++];
+}
+
+bool read_next_int(TextReader *reader, int *value) {
+    int c;
+    do { c = next_char(reader); } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+
+    bool negative = (c == '-');
+    if (negative || c == '+') c = next_char(reader);
+    if (c < '0' || c > '9') return false;
+
+    long long result = 0;
+    while (c >= '0' && c <= '9') {
+        result = result * 10 + (c - '0');
+        c = next_char(reader);
+    }
+    *value = (int)(negative ? -result : result);
+    return true;
+}
+
+int read_int_block(TextReader *reader, int *out, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!read_next_int(reader, &out[i])) {
+            memset(out + i, 0, (count - i) * sizeof(int));
+            return i;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,36 @@
+#ifndef TEXT_READER_H
+#define TEXT_READER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// Lectura rápida de enteros en texto compartida por la versión secuencial y la paralela (no depende
+// de MPI): un fscanf por número sería bastante más lento y la lectura entra en el tiempo medido.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEXT_READER_BUFFER_SIZE (1 << 16)
+
+/** @brief Lector de texto con buffer propio. Se inicializa con el archivo abierto y position = length = 0. */
+typedef struct {
+    FILE *file;
+    int position, length;
+    char buffer[TEXT_READER_BUFFER_SIZE];
+} TextReader;
+
+/** @brief Lee el siguiente entero (separado por espacios). Devuelve false al final o ante un dato inválido. */
+bool read_next_int(TextReader *reader, int *value);
+
+/**
+ * @brief Lee hasta 'count' enteros en 'out' y devuelve cuántos leyó. Si faltan, el resto queda en 0
+ *        (quien reparte por bloques puede completar el protocolo y avisar del error al final).
+ */
+int read_int_block(TextReader *reader, int *out, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_READER_H